@@ -11,7 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstring>
+#include <future>  // NOLINT
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 
 #include "buffer/lru_k_replacer.h"
 #include "common/config.h"
@@ -21,162 +28,851 @@
 
 namespace bustub {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** The longest run of consecutive pages FetchPages reads with a single request. */
+constexpr size_t MAX_READ_RUN_PAGES = 64;
+
+/** How many of the next victims an eviction checks for a clean one before it takes the LRU-K victim. */
+constexpr size_t CLEAN_VICTIM_CANDIDATES = 4;
+
+auto ElapsedNs(Clock::time_point start) -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+}  // namespace
+
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
+                                     LogManager *log_manager, size_t num_shards, bool bind_numa_nodes)
     : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
   // TODO(students): remove this line after you have implemented the buffer pool manager
   // throw NotImplementedException(
   //     "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
   //     "exception line in `buffer_pool_manager.cpp`.");
+  BUSTUB_ENSURE(num_shards > 0 && num_shards <= pool_size_, "invalid number of buffer pool shards");
 
   // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+  arena_ = std::make_unique<FrameArena>(pool_size_, bustub_page_size);
+  pages_ = arena_->GetFrames();
+  int num_numa_nodes = bind_numa_nodes ? FrameArena::NumNumaNodes() : 1;
 
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+  // Each shard takes a contiguous slice of the frames, the first (pool_size % num_shards) shards get one extra frame.
+  // The scan ring is split across the shards, but never takes more than a quarter of a shard.
+  size_t offset = 0;
+  for (size_t i = 0; i < num_shards; ++i) {
+    size_t num_frames = pool_size_ / num_shards + (i < pool_size_ % num_shards ? 1 : 0);
+    size_t scan_ring_size =
+        std::min((SCAN_RING_SIZE + num_shards - 1) / num_shards, std::max<size_t>(1, num_frames / 4));
+    shards_.emplace_back(std::make_unique<BufferPoolShard>(pages_ + offset, num_frames, replacer_k, scan_ring_size));
+    if (num_numa_nodes > 1) {
+      arena_->BindToNode(offset, num_frames, static_cast<int>(i % num_numa_nodes));
+    }
+    offset += num_frames;
+  }
+}
+
+BufferPoolManager::~BufferPoolManager() {
+  StopBackgroundFlush();
+  // Prefetches complete on their own, wait for them before the frames go away.
+  for (auto &shard : shards_) {
+    std::unique_lock lock(shard->latch_);
+    shard->io_cv_.wait(lock, [&] { return shard->io_pending_.empty(); });
   }
+  StopPrefetchPublisher();
+  shards_.clear();
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+void BufferPoolManager::WaitForIO(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id) {
+  shard.io_cv_.wait(lock, [&] { return shard.io_pending_.count(page_id) == 0; });
+}
 
-auto BufferPoolManager::AllocateFrame(page_id_t page_id, frame_id_t *frame_id) -> bool {
-  if (!free_list_.empty()) {
-    *frame_id = free_list_.front();
-    free_list_.erase(free_list_.begin());
+auto BufferPoolManager::LockShard(BufferPoolShard &shard) -> std::unique_lock<std::mutex> {
+  std::unique_lock lock(shard.latch_, std::defer_lock);
+  RelockShard(shard, lock);
+  return lock;
+}
+
+void BufferPoolManager::RelockShard(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock) {
+  // Only read the clock when the latch is contended, so that the common case costs nothing extra.
+  if (lock.try_lock()) {
+    return;
+  }
+  auto start = Clock::now();
+  lock.lock();
+  BufferPoolCounters::Add(shard.stats_.latch_wait_ns_, ElapsedNs(start));
+}
+
+void BufferPoolManager::LatchPage(Page *page, bool exclusive) {
+  if (exclusive ? page->rwlatch_.TryWLock() : page->rwlatch_.TryRLock()) {
+    return;
+  }
+  auto start = Clock::now();
+  if (exclusive) {
+    page->WLatch();
   } else {
-    if (replacer_->Evict(frame_id)) {
-      if (pages_[*frame_id].IsDirty()) {
-        FlushPageNoLock(pages_[*frame_id].GetPageId());
+    page->RLatch();
+  }
+  // The page is pinned, so its id is stable and tells which shard to charge.
+  BufferPoolCounters::Add(GetShard(page->GetPageId()).stats_.page_latch_wait_ns_, ElapsedNs(start));
+}
+
+auto BufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &shard : shards_) {
+    stats += shard->stats_.GetSnapshot();
+  }
+  return stats;
+}
+
+void BufferPoolManager::ResetStats() {
+  for (auto &shard : shards_) {
+    shard->stats_.Reset();
+  }
+}
+
+auto BufferPoolManager::TryClaimFrame(Page &page) -> bool {
+  int expected = 0;
+  return page.pin_count_.compare_exchange_strong(expected, FRAME_CLAIMED);
+}
+
+void BufferPoolManager::ReleaseClaim(Page &page, int pin_count) { page.pin_count_ += pin_count - FRAME_CLAIMED; }
+
+auto BufferPoolManager::TryPinResident(BufferPoolShard &shard, page_id_t page_id, AccessType access_type) -> Page * {
+  frame_id_t frame_id;
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
+    return nullptr;
+  }
+  return TryPinFrame(shard, frame_id, page_id, access_type);
+}
+
+auto BufferPoolManager::TryPinFrame(BufferPoolShard &shard, frame_id_t frame_id, page_id_t page_id,
+                                    AccessType access_type) -> Page * {
+  Page &page = shard.frames_[frame_id];
+  if (page.pin_count_++ < 0) {
+    // The frame is being evicted or deleted.
+    page.pin_count_--;
+    return nullptr;
+  }
+  if (page.page_id_ != page_id) {
+    // The entry was stale, the frame has been reused since.
+    DropStalePin(shard, frame_id);
+    return nullptr;
+  }
+  shard.replacer_->RecordAccess(frame_id, access_type);
+  shard.replacer_->SetEvictable(frame_id, false);
+  BufferPoolCounters::Add(shard.stats_.hits_);
+  return &page;
+}
+
+void BufferPoolManager::DropStalePin(BufferPoolShard &shard, frame_id_t frame_id) {
+  Page &page = shard.frames_[frame_id];
+  if (--page.pin_count_ != 0) {
+    return;
+  }
+  // The owner of the last real pin may have seen ours and left the frame non-evictable. Only a frame that still holds
+  // a resident page belongs in the replacer.
+  auto lock = LockShard(shard);
+  frame_id_t resident_frame_id;
+  if (page.pin_count_ == 0 && page.page_id_ != INVALID_PAGE_ID &&
+      shard.page_table_.Find(page.page_id_, &resident_frame_id) && resident_frame_id == frame_id) {
+    shard.replacer_->SetEvictable(frame_id, true);
+  }
+}
+
+auto BufferPoolManager::TakeFrame(BufferPoolShard &shard, AccessType access_type, page_id_t *victim_page_id)
+    -> frame_id_t {
+  frame_id_t frame_id = -1;
+  *victim_page_id = INVALID_PAGE_ID;
+  Page *page;
+  if (!shard.free_list_.empty()) {
+    frame_id = shard.free_list_.front();
+    shard.free_list_.pop_front();
+    page = &shard.frames_[frame_id];
+    page->pin_count_++;
+  } else {
+    // Resident pages are pinned without the shard latch, so a victim is only taken once it is claimed while unpinned.
+    auto claim = [&shard](frame_id_t fid) { return TryClaimFrame(shard.frames_[fid]); };
+    // While the background flusher runs, take a clean frame among the next few victims so that we don't wait for a
+    // write-back. Further down the queues, a clean frame is too recently used to go before the LRU-K victim.
+    auto claim_clean = [&shard](frame_id_t fid) {
+      return !shard.frames_[fid].IsDirty() && TryClaimFrame(shard.frames_[fid]);
+    };
+    bool evicted =
+        enable_background_flush_ && shard.replacer_->Evict(&frame_id, claim_clean, CLEAN_VICTIM_CANDIDATES);
+    if (!evicted && !shard.replacer_->Evict(&frame_id, claim)) {
+      return -1;
+    }
+    page = &shard.frames_[frame_id];
+    shard.page_table_.Erase(page->GetPageId());
+    BufferPoolCounters::Add(shard.stats_.evictions_);
+    if (page->IsDirty()) {
+      BufferPoolCounters::Add(shard.stats_.dirty_evictions_);
+      *victim_page_id = page->GetPageId();
+      if (enable_background_flush_) {
+        // The flusher is falling behind, wake it up.
+        background_flush_requested_ = true;
+        background_flush_cv_.notify_one();
       }
-      page_table_.erase(pages_[*frame_id].GetPageId());
-    } else {
-      return false;
     }
+    page->page_id_ = INVALID_PAGE_ID;
+    ReleaseClaim(*page, 1);
+  }
+
+  page->is_dirty_ = false;
+  shard.replacer_->RecordAccess(frame_id, access_type);
+  shard.replacer_->SetEvictable(frame_id, false);
+  return frame_id;
+}
+
+auto BufferPoolManager::AllocateFrame(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id,
+                                      bool read_page, AccessType access_type) -> Page * {
+  page_id_t victim_page_id;
+  frame_id_t frame_id = TakeFrame(shard, access_type, &victim_page_id);
+  if (frame_id == -1) {
+    return nullptr;
+  }
+  Page *page = &shard.frames_[frame_id];
+
+  if (victim_page_id == INVALID_PAGE_ID && !read_page) {
+    page->ResetMemory();
+    page->page_id_ = page_id;
+    shard.page_table_.Insert(page_id, frame_id);
+    return page;
+  }
+
+  // Do the disk I/O without holding the shard latch. The frame is pinned, so it cannot be picked as a victim again,
+  // and both the old and the new page are marked as pending so nobody observes a half-written or half-read frame. The
+  // new page only enters the page table once its contents are in place.
+  shard.io_pending_.insert(page_id);
+  if (victim_page_id != INVALID_PAGE_ID) {
+    shard.io_pending_.insert(victim_page_id);
+  }
+  lock.unlock();
+  // The write-back of the victim and the read of the new page are issued together so that an asynchronous disk manager
+  // can overlap them. The victim is written from a private copy because the read refills the frame concurrently.
+  std::unique_ptr<char[]> victim_data;
+  std::future<bool> write_done;
+  std::future<bool> read_done;
+  if (victim_page_id != INVALID_PAGE_ID) {
+    const char *victim_src = page->GetData();
+    if (read_page) {
+      victim_data = std::make_unique<char[]>(bustub_page_size);
+      memcpy(victim_data.get(), page->GetData(), bustub_page_size);
+      victim_src = victim_data.get();
+    }
+    auto promise = std::make_shared<std::promise<bool>>();
+    write_done = promise->get_future();
+    BufferPoolCounters::Add(shard.stats_.writes_);
+    disk_manager_->WritePageAsync(victim_page_id, victim_src, [&shard, promise, start = Clock::now()](bool success) {
+      shard.stats_.write_latency_.Record(Clock::now() - start);
+      promise->set_value(success);
+    });
+  }
+  if (read_page) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    read_done = promise->get_future();
+    BufferPoolCounters::Add(shard.stats_.reads_);
+    disk_manager_->ReadPageAsync(page_id, page->GetData(), [&shard, promise, start = Clock::now()](bool success) {
+      shard.stats_.read_latency_.Record(Clock::now() - start);
+      promise->set_value(success);
+    });
+  }
+  bool write_ok = !write_done.valid() || write_done.get();
+  bool read_ok = !read_done.valid() || read_done.get();
+  if (!read_page && write_ok) {
+    page->ResetMemory();
+  }
+  RelockShard(shard, lock);
+  shard.io_pending_.erase(page_id);
+  if (victim_page_id != INVALID_PAGE_ID) {
+    shard.io_pending_.erase(victim_page_id);
+  }
+  shard.io_cv_.notify_all();
+  // A page that could not be read, or whose frame could not be freed, is not fetched.
+  if (!write_ok) {
+    RestoreVictim(shard, frame_id, victim_page_id, victim_data.get());
+    return nullptr;
+  }
+  if (!read_ok) {
+    ReturnFrame(shard, frame_id);
+    return nullptr;
+  }
+  page->page_id_ = page_id;
+  shard.page_table_.Insert(page_id, frame_id);
+  return page;
+}
+
+void BufferPoolManager::ReturnFrame(BufferPoolShard &shard, frame_id_t frame_id) {
+  Page &page = shard.frames_[frame_id];
+  shard.replacer_->Remove(frame_id);
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  page.ResetMemory();
+  page.pin_count_--;
+  shard.free_list_.push_back(frame_id);
+}
+
+void BufferPoolManager::RestoreVictim(BufferPoolShard &shard, frame_id_t frame_id, page_id_t victim_page_id,
+                                      const char *victim_copy) {
+  Page &page = shard.frames_[frame_id];
+  if (victim_copy != nullptr) {
+    memcpy(page.GetData(), victim_copy, bustub_page_size);
+  }
+  page.page_id_ = victim_page_id;
+  page.is_dirty_ = true;
+  shard.page_table_.Insert(victim_page_id, frame_id);
+  if (--page.pin_count_ == 0) {
+    shard.replacer_->SetEvictable(frame_id, true);
   }
-  pages_[*frame_id].ResetMemory();
-  pages_[*frame_id].page_id_ = page_id;
-  pages_[*frame_id].is_dirty_ = false;
-  pages_[*frame_id].pin_count_ = 1;
-  page_table_[page_id] = *frame_id;
-  replacer_->SetEvictable(*frame_id, false);
-  replacer_->RecordAccess(*frame_id);
-  return true;
 }
 
 auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  frame_id_t frame_id = -1;
-  latch_.lock();
   page_id_t new_page_id = AllocatePage();
-
-  if (!AllocateFrame(new_page_id, &frame_id)) {
-    latch_.unlock();
+  BufferPoolShard &shard = GetShard(new_page_id);
+  auto lock = LockShard(shard);
+  // A recycled page id may still be written back from a previous eviction.
+  WaitForIO(shard, lock, new_page_id);
+  // It may also still be resident if it was prefetched after being deleted. That copy is garbage, drop it.
+  frame_id_t stale_frame_id;
+  if (shard.page_table_.Find(new_page_id, &stale_frame_id) && TryClaimFrame(shard.frames_[stale_frame_id])) {
+    Page &stale_page = shard.frames_[stale_frame_id];
+    shard.page_table_.Erase(new_page_id);
+    shard.replacer_->Remove(stale_frame_id);
+    stale_page.page_id_ = INVALID_PAGE_ID;
+    ReleaseClaim(stale_page, 0);
+    shard.free_list_.push_back(stale_frame_id);
+  }
+  Page *page = AllocateFrame(shard, lock, new_page_id, false);
+  if (page == nullptr) {
     return nullptr;
   }
-  latch_.unlock();
   *page_id = new_page_id;
+  return page;
+}
+
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  BufferPoolShard &shard = GetShard(page_id);
+  // Fast path: a resident page is pinned without taking the shard latch.
+  if (Page *page = TryPinResident(shard, page_id, access_type); page != nullptr) {
+    return page;
+  }
+  auto lock = LockShard(shard);
+  WaitForIO(shard, lock, page_id);
+  frame_id_t frame_id;
+  if (shard.page_table_.Find(page_id, &frame_id)) {
+    // Nobody claims a frame without the shard latch, so this cannot race with an eviction.
+    shard.frames_[frame_id].pin_count_++;
+    shard.replacer_->RecordAccess(frame_id, access_type);
+    shard.replacer_->SetEvictable(frame_id, false);
+    BufferPoolCounters::Add(shard.stats_.hits_);
+    return &shard.frames_[frame_id];
+  }
+  BufferPoolCounters::Add(shard.stats_.misses_);
+  return AllocateFrame(shard, lock, page_id, true, access_type);
+}
+
+auto BufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  std::unordered_map<page_id_t, Page *> fetched;
+  std::vector<std::vector<page_id_t>> shard_page_ids(shards_.size());
+  for (page_id_t page_id : page_ids) {
+    if (fetched.emplace(page_id, nullptr).second) {
+      shard_page_ids[static_cast<size_t>(page_id) % shards_.size()].push_back(page_id);
+    }
+  }
+
+  // Pin what is resident and take frames for the rest, with one latch acquisition per shard. Pages with I/O in flight
+  // are fetched one by one at the end: waiting for them here, while holding frames of our own pending pages, could
+  // deadlock with another batch doing the same.
+  std::vector<FrameLoad> loads;
+  std::vector<page_id_t> deferred;
+  for (size_t i = 0; i < shards_.size(); i++) {
+    if (shard_page_ids[i].empty()) {
+      continue;
+    }
+    BufferPoolShard &shard = *shards_[i];
+    auto lock = LockShard(shard);
+    // Hits first, so that the misses never evict a page of the batch.
+    std::vector<page_id_t> misses;
+    for (page_id_t page_id : shard_page_ids[i]) {
+      frame_id_t frame_id;
+      if (shard.io_pending_.count(page_id) != 0) {
+        deferred.push_back(page_id);
+      } else if (shard.page_table_.Find(page_id, &frame_id)) {
+        shard.frames_[frame_id].pin_count_++;
+        shard.replacer_->RecordAccess(frame_id, access_type);
+        shard.replacer_->SetEvictable(frame_id, false);
+        BufferPoolCounters::Add(shard.stats_.hits_);
+        fetched[page_id] = &shard.frames_[frame_id];
+      } else {
+        misses.push_back(page_id);
+      }
+    }
+    for (page_id_t page_id : misses) {
+      FrameLoad load{&shard, page_id};
+      load.frame_id_ = TakeFrame(shard, access_type, &load.victim_page_id_);
+      if (load.frame_id_ == -1) {
+        // Out of frames, FetchPage decides whether this one fails.
+        deferred.push_back(page_id);
+        continue;
+      }
+      BufferPoolCounters::Add(shard.stats_.misses_);
+      shard.io_pending_.insert(page_id);
+      if (load.victim_page_id_ != INVALID_PAGE_ID) {
+        shard.io_pending_.insert(load.victim_page_id_);
+      }
+      loads.push_back(load);
+    }
+  }
+
+  if (!loads.empty()) {
+    LoadFrames(&loads);
+    for (const auto &load : loads) {
+      fetched[load.page_id_] =
+          load.read_failed_ || load.write_failed_ ? nullptr : &load.shard_->frames_[load.frame_id_];
+    }
+  }
+  for (page_id_t page_id : deferred) {
+    fetched[page_id] = FetchPage(page_id, access_type);
+  }
 
-  return &pages_[frame_id];
+  // Every occurrence of a page id holds its own pin.
+  std::vector<Page *> pages;
+  pages.reserve(page_ids.size());
+  std::unordered_map<page_id_t, bool> pinned;
+  for (page_id_t page_id : page_ids) {
+    Page *page = fetched[page_id];
+    if (page != nullptr && pinned[page_id]) {
+      page->pin_count_++;
+    }
+    pinned[page_id] = true;
+    pages.push_back(page);
+  }
+  return pages;
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
+void BufferPoolManager::LoadFrames(std::vector<FrameLoad> *loads) {
+  std::sort(loads->begin(), loads->end(),
+            [](const FrameLoad &a, const FrameLoad &b) { return a.page_id_ < b.page_id_; });
+
+  // Split the pages into runs of consecutive page ids. Consecutive pages usually live in different shards, so runs are
+  // formed across shards.
+  std::vector<std::pair<size_t, size_t>> runs;
+  for (size_t begin = 0; begin < loads->size();) {
+    size_t end = begin + 1;
+    while (end < loads->size() && end - begin < MAX_READ_RUN_PAGES &&
+           (*loads)[end].page_id_ == (*loads)[end - 1].page_id_ + 1) {
+      end++;
+    }
+    runs.emplace_back(begin, end);
+    begin = end;
+  }
+
+  // Victims are written back from private copies, their frames are refilled by the reads concurrently.
+  size_t num_victims = std::count_if(loads->begin(), loads->end(),
+                                     [](const FrameLoad &load) { return load.victim_page_id_ != INVALID_PAGE_ID; });
+  auto victim_data = std::make_unique<char[]>(num_victims * bustub_page_size);
+  auto promise = std::make_shared<std::promise<void>>();
+  auto remaining = std::make_shared<std::atomic<size_t>>(num_victims + runs.size());
+  auto done = promise->get_future();
+  char *victim_dst = victim_data.get();
+  // Every request sets the flags of its own loads only, and the promise publishes them to this thread.
+  for (auto &load : *loads) {
+    if (load.victim_page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    BufferPoolShard *shard = load.shard_;
+    memcpy(victim_dst, shard->frames_[load.frame_id_].GetData(), bustub_page_size);
+    load.victim_copy_ = victim_dst;
+    BufferPoolCounters::Add(shard->stats_.writes_);
+    disk_manager_->WritePageAsync(load.victim_page_id_, victim_dst,
+                                  [&load, shard, promise, remaining, start = Clock::now()](bool success) {
+                                    shard->stats_.write_latency_.Record(Clock::now() - start);
+                                    load.write_failed_ = !success;
+                                    if (--*remaining == 0) {
+                                      promise->set_value();
+                                    }
+                                  });
+    victim_dst += bustub_page_size;
+  }
+  for (auto [begin, end] : runs) {
+    std::vector<char *> buffers;
+    std::vector<BufferPoolShard *> shards;
+    for (size_t i = begin; i < end; i++) {
+      const FrameLoad &load = (*loads)[i];
+      buffers.push_back(load.shard_->frames_[load.frame_id_].GetData());
+      shards.push_back(load.shard_);
+      BufferPoolCounters::Add(load.shard_->stats_.reads_);
+    }
+    disk_manager_->ReadPagesAsync(
+        (*loads)[begin].page_id_, std::move(buffers),
+        [loads, begin = begin, end = end, shards = std::move(shards), promise, remaining,
+         start = Clock::now()](bool success) {
+          for (auto *shard : shards) {
+            shard->stats_.read_latency_.Record(Clock::now() - start);
+          }
+          for (size_t i = begin; i < end; i++) {
+            (*loads)[i].read_failed_ = !success;
+          }
+          if (--*remaining == 0) {
+            promise->set_value();
+          }
+        });
+  }
+  done.wait();
+
+  // Publish the pages, shard by shard.
+  std::sort(loads->begin(), loads->end(),
+            [](const FrameLoad &a, const FrameLoad &b) { return a.shard_ < b.shard_; });
+  for (size_t begin = 0; begin < loads->size();) {
+    BufferPoolShard &shard = *(*loads)[begin].shard_;
+    auto lock = LockShard(shard);
+    size_t end = begin;
+    for (; end < loads->size() && (*loads)[end].shard_ == &shard; end++) {
+      const FrameLoad &load = (*loads)[end];
+      if (load.write_failed_) {
+        RestoreVictim(shard, load.frame_id_, load.victim_page_id_, load.victim_copy_);
+      } else if (load.read_failed_) {
+        ReturnFrame(shard, load.frame_id_);
+      } else {
+        shard.frames_[load.frame_id_].page_id_ = load.page_id_;
+        shard.page_table_.Insert(load.page_id_, load.frame_id_);
+      }
+      shard.io_pending_.erase(load.page_id_);
+      if (load.victim_page_id_ != INVALID_PAGE_ID) {
+        shard.io_pending_.erase(load.victim_page_id_);
+      }
+    }
+    shard.io_cv_.notify_all();
+    begin = end;
+  }
+}
+
+auto BufferPoolManager::PrefetchPage(page_id_t page_id) -> bool {
+  if (page_id < 0 || page_id >= next_page_id_) {
+    return false;
+  }
+  BufferPoolShard &shard = GetShard(page_id);
+  auto lock = LockShard(shard);
   frame_id_t frame_id = -1;
-  latch_.lock();
-  if (page_table_.count(page_id) != 0) {
-    frame_id = page_table_[page_id];
-    pages_[frame_id].pin_count_++;
-    replacer_->SetEvictable(frame_id, false);
-    replacer_->RecordAccess(frame_id);
-    latch_.unlock();
-    return &pages_[frame_id];
-  }
-
-  if (!AllocateFrame(page_id, &frame_id)) {
-    latch_.unlock();
-    return nullptr;
+  if (shard.io_pending_.count(page_id) != 0 || shard.page_table_.Find(page_id, &frame_id)) {
+    return false;
   }
+  Page *page;
+  if (!shard.free_list_.empty()) {
+    frame_id = shard.free_list_.front();
+    shard.free_list_.pop_front();
+    page = &shard.frames_[frame_id];
+    page->pin_count_++;
+  } else {
+    // A prefetch is only a hint: it may recycle a clean frame of the scan ring, but never write back a page or push
+    // another page out of the pool.
+    auto claim_clean = [&shard](frame_id_t fid) {
+      return !shard.frames_[fid].IsDirty() && TryClaimFrame(shard.frames_[fid]);
+    };
+    if (!shard.replacer_->EvictScanFrame(&frame_id, claim_clean)) {
+      return false;
+    }
+    page = &shard.frames_[frame_id];
+    shard.page_table_.Erase(page->GetPageId());
+    BufferPoolCounters::Add(shard.stats_.evictions_);
+    page->page_id_ = INVALID_PAGE_ID;
+    ReleaseClaim(*page, 1);
+  }
+
+  // The frame stays pinned and the page pending until the read completes, then it becomes an ordinary unpinned page.
+  page->is_dirty_ = false;
+  shard.replacer_->RecordAccess(frame_id, AccessType::Scan);
+  shard.replacer_->SetEvictable(frame_id, false);
+  shard.io_pending_.insert(page_id);
+  lock.unlock();
+
+  BufferPoolCounters::Add(shard.stats_.reads_);
+  auto issuer = std::this_thread::get_id();
+  auto start = Clock::now();
+  disk_manager_->ReadPageAsync(
+      page_id, page->GetData(), [this, &shard, page_id, frame_id, issuer, start](bool success) {
+        shard.stats_.read_latency_.Record(Clock::now() - start);
+        // A read completed inline is published right away, this thread holds no latch.
+        if (std::this_thread::get_id() == issuer) {
+          PublishPrefetch({&shard, page_id, frame_id, success});
+          return;
+        }
+        std::call_once(prefetch_thread_started_,
+                       [this] { prefetch_thread_ = new std::thread(&BufferPoolManager::RunPrefetchPublisher, this); });
+        // Notified under the latch: once the entry is taken, the pool may be destroyed before this thread returns.
+        std::scoped_lock lock(prefetch_latch_);
+        prefetch_done_.push_back({&shard, page_id, frame_id, success});
+        prefetch_cv_.notify_one();
+      });
+  return true;
+}
+
+void BufferPoolManager::RunPrefetchPublisher() {
+  std::unique_lock lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [&] { return stop_prefetch_thread_ || !prefetch_done_.empty(); });
+    if (prefetch_done_.empty()) {
+      return;
+    }
+    auto batch = std::move(prefetch_done_);
+    prefetch_done_.clear();
+    lock.unlock();
+    for (const auto &done : batch) {
+      PublishPrefetch(done);
+    }
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::PublishPrefetch(const PrefetchDone &done) {
+  BufferPoolShard &shard = *done.shard_;
+  auto lock = LockShard(shard);
+  Page &page = shard.frames_[done.frame_id_];
+  if (done.success_) {
+    page.page_id_ = done.page_id_;
+    shard.page_table_.Insert(done.page_id_, done.frame_id_);
+    if (--page.pin_count_ == 0) {
+      shard.replacer_->SetEvictable(done.frame_id_, true);
+    }
+  } else {
+    ReturnFrame(shard, done.frame_id_);
+  }
+  shard.io_pending_.erase(done.page_id_);
+  shard.io_cv_.notify_all();
+}
 
-  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
-  latch_.unlock();
-  return &pages_[frame_id];
+void BufferPoolManager::StopPrefetchPublisher() {
+  if (prefetch_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::scoped_lock lock(prefetch_latch_);
+    stop_prefetch_thread_ = true;
+  }
+  prefetch_cv_.notify_one();
+  prefetch_thread_->join();
+  delete prefetch_thread_;
+  prefetch_thread_ = nullptr;
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  latch_.lock();
-  if (page_table_.count(page_id) == 0) {
-    latch_.unlock();
-    return false;
+  BufferPoolShard &shard = GetShard(page_id);
+  // The caller holds a pin, so the page stays in its frame and the lookup needs no latch. Only a lookup racing with an
+  // unrelated Erase can miss, retry those under the latch.
+  frame_id_t frame_id;
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
+    auto lock = LockShard(shard);
+    if (!shard.page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
   }
-  frame_id_t frame_id = page_table_[page_id];
-  if (pages_[frame_id].pin_count_ == 0) {
-    latch_.unlock();
+  Page &page = shard.frames_[frame_id];
+  int pin_count = page.pin_count_;
+  if (pin_count <= 0 || page.page_id_ != page_id) {
     return false;
   }
-  pages_[frame_id].pin_count_--;
-  pages_[frame_id].is_dirty_ = is_dirty || pages_[frame_id].is_dirty_;
+  // Mark the page dirty before dropping the pin, so that whoever evicts it next sees the flag.
+  if (is_dirty) {
+    page.is_dirty_ = true;
+  }
+  while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count - 1)) {
+    if (pin_count <= 0) {
+      return false;
+    }
+  }
 
-  if (pages_[frame_id].GetPinCount() == 0) {
-    replacer_->SetEvictable(frame_id, true);
+  if (pin_count == 1) {
+    shard.replacer_->SetEvictable(frame_id, true);
   }
-  latch_.unlock();
   return true;
 }
 
-auto BufferPoolManager::FlushPageNoLock(page_id_t page_id) -> bool {
-  if (page_table_.count(page_id) == 0) {
+auto BufferPoolManager::FlushPageNoLock(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id)
+    -> bool {
+  WaitForIO(shard, lock, page_id);
+  frame_id_t frame_id;
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
     return false;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
-  pages_[frame_id].is_dirty_ = false;
+  // Nobody claims a frame without the shard latch, so the pin keeps the page in its frame during the write.
+  Page &page = shard.frames_[frame_id];
+  page.pin_count_++;
+  shard.replacer_->SetEvictable(frame_id, false);
+  // Clear the flag first: a writer that unpins the page while it is being written marks it dirty again.
+  page.is_dirty_ = false;
+  shard.io_pending_.insert(page_id);
+  lock.unlock();
+
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto write_done = promise->get_future();
+  auto start = Clock::now();
+  disk_manager_->WritePageAsync(page_id, page.GetData(), [promise](bool success) { promise->set_value(success); });
+  bool write_ok = write_done.get();
+  shard.stats_.write_latency_.Record(Clock::now() - start);
+  BufferPoolCounters::Add(shard.stats_.writes_);
+  BufferPoolCounters::Add(shard.stats_.flushes_);
+
+  RelockShard(shard, lock);
+  if (!write_ok) {
+    page.is_dirty_ = true;
+  }
+  shard.io_pending_.erase(page_id);
+  shard.io_cv_.notify_all();
+  if (--page.pin_count_ == 0) {
+    shard.replacer_->SetEvictable(frame_id, true);
+  }
   return true;
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  latch_.lock();
-  if (FlushPageNoLock(page_id)) {
-    latch_.unlock();
-    return true;
-  }
-  latch_.unlock();
-  return false;
+  BufferPoolShard &shard = GetShard(page_id);
+  auto lock = LockShard(shard);
+  return FlushPageNoLock(shard, lock, page_id);
 }
 
 void BufferPoolManager::FlushAllPages() {
-  latch_.lock();
-  for (auto &it : page_table_) {
-    FlushPageNoLock(it.first);
+  for (auto &shard : shards_) {
+    auto lock = LockShard(*shard);
+    // Pages still being read in are not in the page table yet, and have nothing worth writing anyway.
+    std::vector<page_id_t> page_ids;
+    shard->page_table_.ForEach([&](page_id_t page_id, frame_id_t /* frame_id */) { page_ids.push_back(page_id); });
+    // The latch is dropped during every write, a page that was evicted or deleted meanwhile is skipped.
+    for (page_id_t page_id : page_ids) {
+      FlushPageNoLock(*shard, lock, page_id);
+    }
   }
-  latch_.unlock();
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  latch_.lock();
-  if (page_table_.count(page_id) == 0) {
-    latch_.unlock();
+  BufferPoolShard &shard = GetShard(page_id);
+  auto lock = LockShard(shard);
+  WaitForIO(shard, lock, page_id);
+  frame_id_t frame_id;
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
     return true;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  if (pages_[frame_id].GetPinCount() != 0) {
-    latch_.unlock();
+  Page &page = shard.frames_[frame_id];
+  if (!TryClaimFrame(page)) {
     return false;
   }
-  page_table_.erase(page_id);
-  replacer_->Remove(frame_id);
-  pages_[frame_id].page_id_ = 0;
-  pages_[frame_id].is_dirty_ = false;
-  pages_[frame_id].pin_count_ = 0;
-  pages_[frame_id].ResetMemory();
-  free_list_.push_front(frame_id);
+  shard.page_table_.Erase(page_id);
+  shard.replacer_->Remove(frame_id);
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  page.ResetMemory();
+  ReleaseClaim(page, 0);
+  shard.free_list_.push_front(frame_id);
+  lock.unlock();
 
   DeallocatePage(page_id);
-
-  latch_.unlock();
   return true;
 }
 
+void BufferPoolManager::StartBackgroundFlush(double clean_ratio) {
+  BUSTUB_ENSURE(clean_ratio > 0 && clean_ratio <= 1, "invalid background flush clean ratio");
+  StopBackgroundFlush();
+  background_flush_clean_ratio_ = clean_ratio;
+  enable_background_flush_ = true;
+  background_flush_thread_ = new std::thread(&BufferPoolManager::RunBackgroundFlush, this);
+}
+
+void BufferPoolManager::StopBackgroundFlush() {
+  if (background_flush_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::scoped_lock lock(background_flush_latch_);
+    enable_background_flush_ = false;
+  }
+  background_flush_cv_.notify_one();
+  background_flush_thread_->join();
+  delete background_flush_thread_;
+  background_flush_thread_ = nullptr;
+}
+
+void BufferPoolManager::RunBackgroundFlush() {
+  while (enable_background_flush_) {
+    {
+      std::unique_lock lock(background_flush_latch_);
+      background_flush_cv_.wait_for(lock, background_flush_interval,
+                                    [&] { return !enable_background_flush_ || background_flush_requested_; });
+      background_flush_requested_ = false;
+    }
+    if (!enable_background_flush_) {
+      break;
+    }
+    for (auto &shard : shards_) {
+      FlushShardInBackground(*shard);
+    }
+  }
+}
+
+void BufferPoolManager::FlushShardInBackground(BufferPoolShard &shard) {
+  // Snapshot the dirty pages among the next victims. They are unpinned when picked, but may be pinned again without the
+  // shard latch, so the dirty flag is cleared before the copy: a writer racing with it marks the page dirty again when
+  // it unpins. The pages are marked as pending until the write lands, so a fetch after an eviction can't read the old
+  // contents back from disk.
+  std::vector<std::pair<page_id_t, frame_id_t>> batch;
+  std::unique_ptr<char[]> buffer;
+  {
+    auto lock = LockShard(shard);
+    auto target = static_cast<size_t>(std::ceil(background_flush_clean_ratio_ * shard.replacer_->Size()));
+    for (frame_id_t frame_id : shard.replacer_->PeekVictims(target)) {
+      Page &page = shard.frames_[frame_id];
+      if (page.IsDirty()) {
+        batch.emplace_back(page.GetPageId(), frame_id);
+      }
+    }
+    if (batch.empty()) {
+      return;
+    }
+    // Neighbouring pages are written one after another so that the disk sees a mostly sequential stream.
+    std::sort(batch.begin(), batch.end());
+    buffer = std::make_unique<char[]>(batch.size() * bustub_page_size);
+    for (size_t i = 0; i < batch.size(); i++) {
+      Page &page = shard.frames_[batch[i].second];
+      page.is_dirty_ = false;
+      memcpy(buffer.get() + i * bustub_page_size, page.GetData(), bustub_page_size);
+      shard.io_pending_.insert(batch[i].first);
+    }
+  }
+
+  auto promise = std::make_shared<std::promise<void>>();
+  auto remaining = std::make_shared<std::atomic<size_t>>(batch.size());
+  auto done = promise->get_future();
+  // One flag per write, published to this thread by the promise.
+  auto failed = std::make_unique<bool[]>(batch.size());
+  BufferPoolCounters::Add(shard.stats_.writes_, batch.size());
+  BufferPoolCounters::Add(shard.stats_.flushes_, batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    disk_manager_->WritePageAsync(batch[i].first, buffer.get() + i * bustub_page_size,
+                                  [&shard, flag = &failed[i], promise, remaining, start = Clock::now()](bool success) {
+                                    shard.stats_.write_latency_.Record(Clock::now() - start);
+                                    *flag = !success;
+                                    if (--*remaining == 0) {
+                                      promise->set_value();
+                                    }
+                                  });
+  }
+  done.wait();
+
+  auto lock = LockShard(shard);
+  for (size_t i = 0; i < batch.size(); i++) {
+    auto [page_id, frame_id] = batch[i];
+    // A page whose write failed is dirty again, unless it has left its frame since.
+    if (failed[i] && shard.frames_[frame_id].GetPageId() == page_id) {
+      shard.frames_[frame_id].is_dirty_ = true;
+    }
+    shard.io_pending_.erase(page_id);
+  }
+  shard.io_cv_.notify_all();
+}
+
 auto BufferPoolManager::AllocatePage() -> page_id_t {
+  std::scoped_lock lock(page_id_latch_);
   if (free_page_id_.empty()) {
     return next_page_id_++;
   }
@@ -185,29 +881,67 @@ auto BufferPoolManager::AllocatePage() -> page_id_t {
   return ret;
 }
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
   // return {this, nullptr};
-  return {this, FetchPage(page_id)};
+  return {this, FetchPage(page_id, access_type)};
 }
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
   // return {this, nullptr};
-  Page *page = FetchPage(page_id);
+  Page *page = FetchPage(page_id, access_type);
   if (page != nullptr) {
-    page->RLatch();
+    LatchPage(page, false);
+  }
+  return {this, page};
+}
+
+auto BufferPoolManager::FetchPageReadInFrame(Page *frame, page_id_t page_id, AccessType access_type)
+    -> ReadPageGuard {
+  BufferPoolShard &shard = GetShard(page_id);
+  // A page only ever moves between frames of its own shard.
+  if (frame < shard.frames_ || frame >= shard.frames_ + shard.num_frames_) {
+    return {};
+  }
+  Page *page = TryPinFrame(shard, static_cast<frame_id_t>(frame - shard.frames_), page_id, access_type);
+  if (page == nullptr) {
+    return {};
   }
+  LatchPage(page, false);
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
   // return {this, nullptr};
-  Page *page = FetchPage(page_id);
+  Page *page = FetchPage(page_id, access_type);
   if (page != nullptr) {
-    page->WLatch();
+    LatchPage(page, true);
   }
   return {this, page};
 }
 
+auto BufferPoolManager::FetchPagesBasic(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<BasicPageGuard> {
+  std::vector<BasicPageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (Page *page : FetchPages(page_ids, access_type)) {
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
+
+auto BufferPoolManager::FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<ReadPageGuard> {
+  std::vector<ReadPageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (Page *page : FetchPages(page_ids, access_type)) {
+    if (page != nullptr) {
+      LatchPage(page, false);
+    }
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
+
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard {
   // return {this, nullptr};
   Page *page = NewPage(page_id);
@@ -218,7 +952,7 @@ auto BufferPoolManager::NewPageWrite(page_id_t *page_id) -> WritePageGuard {
   // return {this, nullptr};
   Page *page = NewPage(page_id);
   if (page != nullptr) {
-    page->WLatch();
+    LatchPage(page, true);
   }
   return {this, page};
 }
@@ -227,7 +961,7 @@ auto BufferPoolManager::NewPageRead(page_id_t *page_id) -> ReadPageGuard {
   // return {this, nullptr};
   Page *page = NewPage(page_id);
   if (page != nullptr) {
-    page->RLatch();
+    LatchPage(page, false);
   }
   return {this, page};
 }
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto LatencyHistogram::BucketOf(uint64_t micros) -> size_t {
+  if (micros == 0) {
+    return 0;
+  }
+  // The number of significant bits, so that [2^(i-1), 2^i) lands in bucket i.
+  return std::min<size_t>(64 - __builtin_clzll(micros), NUM_BUCKETS - 1);
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  auto ns = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  buckets_[BucketOf(ns / 1000)].fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::GetSnapshot() const -> Snapshot {
+  Snapshot snapshot;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    snapshot.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+    snapshot.count_ += snapshot.buckets_[i];
+  }
+  snapshot.total_ns_ = total_ns_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  total_ns_.store(0, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::Snapshot::operator+=(const Snapshot &other) -> Snapshot & {
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_ns_ += other.total_ns_;
+  return *this;
+}
+
+auto LatencyHistogram::Snapshot::MeanMicros() const -> double {
+  return count_ == 0 ? 0 : static_cast<double>(total_ns_) / 1000 / static_cast<double>(count_);
+}
+
+auto LatencyHistogram::Snapshot::PercentileMicros(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * static_cast<double>(count_))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      // The exclusive upper bound of the bucket.
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (NUM_BUCKETS - 1);
+}
+
+auto LatencyHistogram::Snapshot::ToJson() const -> std::string {
+  return fmt::format(R"({{"count": {}, "mean_us": {:.3f}, "p50_us": {}, "p99_us": {}, "buckets": [{}]}})", count_,
+                     MeanMicros(), PercentileMicros(50), PercentileMicros(99), fmt::join(buckets_, ", "));
+}
+
+auto BufferPoolStats::operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  evictions_ += other.evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  reads_ += other.reads_;
+  writes_ += other.writes_;
+  flushes_ += other.flushes_;
+  latch_wait_ns_ += other.latch_wait_ns_;
+  page_latch_wait_ns_ += other.page_latch_wait_ns_;
+  read_latency_ += other.read_latency_;
+  write_latency_ += other.write_latency_;
+  return *this;
+}
+
+auto BufferPoolStats::HitRatio() const -> double {
+  return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_);
+}
+
+auto BufferPoolStats::ToJson() const -> std::string {
+  return fmt::format(
+      R"({{"hits": {}, "misses": {}, "hit_ratio": {:.4f}, "evictions": {}, "dirty_evictions": {}, "reads": {}, )"
+      R"("writes": {}, "flushes": {}, "latch_wait_ns": {}, "page_latch_wait_ns": {}, "read_latency": {}, )"
+      R"("write_latency": {}}})",
+      hits_, misses_, HitRatio(), evictions_, dirty_evictions_, reads_, writes_, flushes_, latch_wait_ns_,
+      page_latch_wait_ns_, read_latency_.ToJson(), write_latency_.ToJson());
+}
+
+auto BufferPoolCounters::GetSnapshot() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  stats.hits_ = hits_.load(std::memory_order_relaxed);
+  stats.misses_ = misses_.load(std::memory_order_relaxed);
+  stats.evictions_ = evictions_.load(std::memory_order_relaxed);
+  stats.dirty_evictions_ = dirty_evictions_.load(std::memory_order_relaxed);
+  stats.reads_ = reads_.load(std::memory_order_relaxed);
+  stats.writes_ = writes_.load(std::memory_order_relaxed);
+  stats.flushes_ = flushes_.load(std::memory_order_relaxed);
+  stats.latch_wait_ns_ = latch_wait_ns_.load(std::memory_order_relaxed);
+  stats.page_latch_wait_ns_ = page_latch_wait_ns_.load(std::memory_order_relaxed);
+  stats.read_latency_ = read_latency_.GetSnapshot();
+  stats.write_latency_ = write_latency_.GetSnapshot();
+  return stats;
+}
+
+void BufferPoolCounters::Reset() {
+  for (auto *counter : {&hits_, &misses_, &evictions_, &dirty_evictions_, &reads_, &writes_, &flushes_,
+                        &latch_wait_ns_, &page_latch_wait_ns_}) {
+    counter->store(0, std::memory_order_relaxed);
+  }
+  read_latency_.Reset();
+  write_latency_.Reset();
+}
+
+}  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE_2MB = 2UL << 20;
+constexpr size_t HUGE_PAGE_SIZE_1GB = 1UL << 30;
+/** MPOL_BIND from <numaif.h>, which we don't want to depend on for a single constant. */
+constexpr int MPOL_BIND_MODE = 2;
+
+auto RoundUp(size_t value, size_t unit) -> size_t { return (value + unit - 1) / unit * unit; }
+
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, size_t page_size) : num_frames_(num_frames), page_size_(page_size) {
+  MapData();
+  std::allocator<Page> allocator;
+  frames_ = allocator.allocate(num_frames_);
+  for (size_t i = 0; i < num_frames_; i++) {
+    new (frames_ + i) Page(data_ + i * page_size_);
+  }
+}
+
+FrameArena::~FrameArena() {
+  std::destroy_n(frames_, num_frames_);
+  std::allocator<Page>().deallocate(frames_, num_frames_);
+  munmap(data_, data_size_);
+}
+
+void FrameArena::MapData() {
+  size_t size = std::max<size_t>(num_frames_ * page_size_, 1);
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  // Explicit huge pages only exist if the administrator reserved them, so each attempt may fail.
+  for (size_t huge_page_size : {HUGE_PAGE_SIZE_1GB, HUGE_PAGE_SIZE_2MB}) {
+    // Don't round a small pool up to a whole 1GB page.
+    if (huge_page_size == HUGE_PAGE_SIZE_1GB && size < HUGE_PAGE_SIZE_1GB) {
+      continue;
+    }
+    int huge_flag = (__builtin_ctzl(huge_page_size) << MAP_HUGE_SHIFT);
+    size_t rounded = RoundUp(size, huge_page_size);
+    void *addr = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_flag,
+                      -1, 0);
+    if (addr != MAP_FAILED) {
+      data_ = static_cast<char *>(addr);
+      data_size_ = rounded;
+      mapping_page_size_ = huge_page_size;
+      return;
+    }
+  }
+#endif
+
+  size_t system_page_size = sysconf(_SC_PAGESIZE);
+  data_size_ = RoundUp(size, system_page_size);
+  void *addr = mmap(nullptr, data_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the buffer pool");
+  }
+  data_ = static_cast<char *>(addr);
+  mapping_page_size_ = system_page_size;
+#ifdef MADV_HUGEPAGE
+  // Fall back to transparent huge pages. This is only a hint, so the result doesn't matter.
+  madvise(data_, data_size_, MADV_HUGEPAGE);
+#endif
+}
+
+auto FrameArena::BindToNode(size_t first_frame, size_t num_frames, int node) -> bool {
+#if defined(__linux__) && defined(SYS_mbind)
+  auto begin = reinterpret_cast<uintptr_t>(data_ + first_frame * page_size_);
+  auto end = reinterpret_cast<uintptr_t>(data_ + (first_frame + num_frames) * page_size_);
+  begin = RoundUp(begin, mapping_page_size_);
+  end = end / mapping_page_size_ * mapping_page_size_;
+  if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8) || begin >= end) {  // NOLINT
+    return false;
+  }
+  unsigned long node_mask = 1UL << node;  // NOLINT
+  if (syscall(SYS_mbind, begin, end - begin, MPOL_BIND_MODE, &node_mask, sizeof(node_mask) * 8, 0) != 0) {
+    LOG_DEBUG("mbind to node %d failed", node);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+auto FrameArena::NumNumaNodes() -> int {
+  // The file holds a list of ranges such as "0-3" or "0,2-3", the last number is the highest node id.
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string nodes;
+  if (!(online >> nodes) || nodes.empty()) {
+    return 1;
+  }
+  size_t start = nodes.find_last_of(",-");
+  start = start == std::string::npos ? 0 : start + 1;
+  try {
+    return std::stoi(nodes.substr(start)) + 1;
+  } catch (std::exception &e) {
+    return 1;
+  }
+}
+
+}  // namespace bustub
@@ -17,84 +17,169 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k, size_t scan_ring_size)
+    : node_store_(num_frames), scan_ring_size_(scan_ring_size), replacer_size_(num_frames), k_(k) {
+  for (size_t i = 0; i < num_frames; i++) {
+    node_store_[i].fid_ = static_cast<frame_id_t>(i);
+    node_store_[i].history_.resize(k);
+  }
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-  frame_id_t evict_id = -1;
-  // size_t evict_k = 0;
+auto LRUKReplacer::GetNode(frame_id_t frame_id) -> LRUKNode & {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  return node_store_[frame_id];
+}
 
-  latch_.lock();
-  for (auto const &it : node_store_) {
-    if (!it.second.is_evictable_) {
-      continue;
-    }
-    if (evict_id == -1) {
-      evict_id = it.first;
-    } else {
-      const LRUKNode &old_node = node_store_[evict_id];
-      if (old_node.history_.size() >= this->k_) {
-        if (it.second.history_.size() < this->k_ || it.second.k_ < old_node.k_) {
-          evict_id = it.first;
-        }
-      } else {
-        if (it.second.history_.size() < this->k_ && it.second.k_ < old_node.k_) {
-          evict_id = it.first;
-        }
+void LRUKReplacer::RemoveNode(LRUKNode &node) {
+  if (node.is_evictable_) {
+    QueueOf(node).erase({node.k_, node.fid_});
+    this->curr_size_--;
+  }
+  node.in_use_ = false;
+  node.is_evictable_ = false;
+  node.scan_only_ = false;
+  node.head_ = 0;
+  node.count_ = 0;
+  node.k_ = 0;
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool { return Evict(frame_id, nullptr); }
+
+void LRUKReplacer::VisitVictims(const std::function<bool(frame_id_t)> &visit) {
+  auto scan_it = scan_queue_.begin();
+  // Once the scan ring is full, scans recycle their own frames first.
+  if (scan_ring_size_ > 0 && scan_queue_.size() >= scan_ring_size_) {
+    for (; scan_it != scan_queue_.end(); ++scan_it) {
+      if (!visit(scan_it->second)) {
+        return;
       }
     }
   }
-  latch_.unlock();
-  if (evict_id == -1) {
+  // Otherwise a scan frame counts as a frame with +inf k-distance, so merge the two queues by timestamp.
+  auto inf_it = inf_queue_.begin();
+  while (inf_it != inf_queue_.end() || scan_it != scan_queue_.end()) {
+    bool take_scan = inf_it == inf_queue_.end() || (scan_it != scan_queue_.end() && *scan_it < *inf_it);
+    auto &it = take_scan ? scan_it : inf_it;
+    if (!visit(it->second)) {
+      return;
+    }
+    ++it;
+  }
+  for (auto const &[key, fid] : kdist_queue_) {
+    if (!visit(fid)) {
+      return;
+    }
+  }
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &filter,
+                         size_t max_candidates) -> bool {
+  std::scoped_lock lock(latch_);
+  // Without a filter the first victim is taken. With one, no more than max_candidates victims are tried.
+  bool found = false;
+  size_t candidates = 0;
+  VisitVictims([&](frame_id_t fid) {
+    if (filter && !filter(fid)) {
+      return ++candidates < max_candidates;
+    }
+    *frame_id = fid;
+    found = true;
     return false;
+  });
+  if (found) {
+    RemoveNode(node_store_[*frame_id]);
   }
-  Remove(evict_id);
-  *frame_id = evict_id;
-  return true;
+  return found;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
-  latch_.lock();
+auto LRUKReplacer::EvictScanFrame(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &filter,
+                                  size_t max_candidates) -> bool {
+  std::scoped_lock lock(latch_);
+  size_t candidates = 0;
+  for (auto const &[key, fid] : scan_queue_) {
+    if (candidates++ == max_candidates) {
+      break;
+    }
+    if (!filter || filter(fid)) {
+      *frame_id = fid;
+      RemoveNode(node_store_[fid]);
+      return true;
+    }
+  }
+  return false;
+}
 
-  LRUKNode &node = node_store_[frame_id];
-  size_t time = ++current_timestamp_;
-  node.fid_ = frame_id;
-  node.history_.push_front(time);
-  if (node.history_.size() >= this->k_) {
-    auto iter = node.history_.begin();
-    for (size_t i = 0; i < this->k_ - 1; i++) {
-      iter++;
+auto LRUKReplacer::PeekVictims(size_t count) -> std::vector<frame_id_t> {
+  std::scoped_lock lock(latch_);
+  std::vector<frame_id_t> victims;
+  if (count == 0) {
+    return victims;
+  }
+  VisitVictims([&](frame_id_t fid) {
+    victims.push_back(fid);
+    return victims.size() < count;
+  });
+  return victims;
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  std::scoped_lock lock(latch_);
+  LRUKNode &node = GetNode(frame_id);
+  if (node.is_evictable_) {
+    QueueOf(node).erase({node.k_, node.fid_});
+  }
+  if (scan_ring_size_ > 0 && access_type == AccessType::Scan) {
+    // A scan neither creates nor extends LRU-K history; it only refreshes frames that scans alone brought in.
+    if (!node.in_use_ || node.scan_only_) {
+      node.in_use_ = true;
+      node.scan_only_ = true;
+      node.k_ = ++current_timestamp_;
     }
-    node.k_ = *iter;
   } else {
-    node.k_ = node.history_.back();
+    if (node.scan_only_) {
+      // First real access, the frame joins the LRU-K history from scratch.
+      node.scan_only_ = false;
+      node.head_ = 0;
+      node.count_ = 0;
+    }
+    node.in_use_ = true;
+    node.history_[node.head_] = ++current_timestamp_;
+    node.head_ = (node.head_ + 1) % this->k_;
+    if (node.count_ < this->k_) {
+      node.count_++;
+    }
+    // Until the ring is full the earliest access sits in slot 0; afterwards the slot about to be overwritten holds the
+    // k-th most recent access.
+    node.k_ = node.count_ < this->k_ ? node.history_[0] : node.history_[node.head_];
+  }
+  if (node.is_evictable_) {
+    QueueOf(node).emplace(node.k_, node.fid_);
   }
-  latch_.unlock();
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
-  latch_.lock();
-  LRUKNode &node = node_store_[frame_id];
-  node.fid_ = frame_id;
-  if (set_evictable != node.is_evictable_) {
-    if (set_evictable) {
-      this->curr_size_++;
-    } else {
-      this->curr_size_--;
-    }
-    node.is_evictable_ = set_evictable;
+  std::scoped_lock lock(latch_);
+  LRUKNode &node = GetNode(frame_id);
+  // An untracked frame has no history to be evicted by, leave it alone.
+  if (!node.in_use_ || set_evictable == node.is_evictable_) {
+    return;
   }
-  latch_.unlock();
+  if (set_evictable) {
+    QueueOf(node).emplace(node.k_, node.fid_);
+    this->curr_size_++;
+  } else {
+    QueueOf(node).erase({node.k_, node.fid_});
+    this->curr_size_--;
+  }
+  node.is_evictable_ = set_evictable;
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  latch_.lock();
-  if (node_store_.count(frame_id) != 0) {
-    if (node_store_[frame_id].is_evictable_) {
-      this->curr_size_--;
-    }
-    node_store_.erase(frame_id);
+  std::scoped_lock lock(latch_);
+  LRUKNode &node = GetNode(frame_id);
+  if (node.in_use_) {
+    RemoveNode(node);
   }
-  latch_.unlock();
 }
 
 auto LRUKReplacer::Size() -> size_t { return curr_size_; }
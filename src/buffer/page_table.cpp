@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  // At most half full, so probe sequences stay short.
+  capacity_ = 8;
+  while (capacity_ < 2 * num_frames) {
+    capacity_ *= 2;
+  }
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto PageTable::Home(page_id_t page_id) const -> size_t {
+  // Page ids are dense, so spread them with a Fibonacci hash rather than using the low bits directly.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> 20) &
+         (capacity_ - 1);
+}
+
+auto PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  for (size_t i = Home(page_id);; i = (i + 1) & (capacity_ - 1)) {
+    uint64_t slot = slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageOf(slot) == page_id) {
+      *frame_id = FrameOf(slot);
+      return true;
+    }
+  }
+}
+
+auto PageTable::Locate(page_id_t page_id) const -> size_t {
+  size_t i = Home(page_id);
+  for (;; i = (i + 1) & (capacity_ - 1)) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT || PageOf(slot) == page_id) {
+      return i;
+    }
+  }
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  size_t i = Locate(page_id);
+  if (slots_[i].load(std::memory_order_relaxed) == EMPTY_SLOT) {
+    BUSTUB_ASSERT(size_ + 1 < capacity_, "page table is full");
+    size_++;
+  }
+  slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+}
+
+auto PageTable::Erase(page_id_t page_id) -> bool {
+  size_t hole = Locate(page_id);
+  if (slots_[hole].load(std::memory_order_relaxed) == EMPTY_SLOT) {
+    return false;
+  }
+  size_--;
+  // Backward-shift deletion: move later entries of the cluster into the hole whenever the hole lies on their probe
+  // sequence, so that no tombstones are needed. Each entry is copied before its old slot is cleared, so a concurrent
+  // Find can only miss it, never see a wrong frame.
+  for (size_t i = (hole + 1) & (capacity_ - 1);; i = (i + 1) & (capacity_ - 1)) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = Home(PageOf(slot));
+    // The entry may move iff its home is not cyclically within (hole, i].
+    bool reachable = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+    if (!reachable) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = i;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  return true;
+}
+
+void PageTable::ForEach(const std::function<void(page_id_t, frame_id_t)> &visit) const {
+  for (size_t i = 0; i < capacity_; i++) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot != EMPTY_SLOT) {
+      visit(PageOf(slot), FrameOf(slot));
+    }
+  }
+}
+
+}  // namespace bustub
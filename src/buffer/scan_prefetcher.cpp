@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// scan_prefetcher.cpp
+//
+// Identification: src/buffer/scan_prefetcher.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/scan_prefetcher.h"
+
+#include <algorithm>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+void ScanPrefetcher::Advance(page_id_t page_id) {
+  if (depth_ == 0 || page_id == INVALID_PAGE_ID || page_id == current_) {
+    return;
+  }
+  current_ = page_id;
+  auto it = std::find(window_.begin(), window_.end(), page_id);
+  if (it == window_.end()) {
+    // The scan left the chain we were following (or just started), start over from here.
+    window_.clear();
+  } else {
+    window_.erase(window_.begin(), it + 1);
+  }
+
+  // Grow the window by at most two pages per step, so that the page we read the next id from has had time to arrive.
+  page_id_t horizon = window_.empty() ? current_ : window_.back();
+  for (int step = 0; step < 2 && window_.size() < depth_; step++) {
+    Page *page = bpm_->FetchPage(horizon, AccessType::Scan);
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    page_id_t next_page_id = next_page_(page->GetData());
+    page->RUnlatch();
+    bpm_->UnpinPage(horizon, false, AccessType::Scan);
+    if (next_page_id == INVALID_PAGE_ID || next_page_id == current_) {
+      return;
+    }
+    bpm_->PrefetchPage(next_page_id);
+    window_.push_back(next_page_id);
+    horizon = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -56,11 +56,27 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   for (const auto &col : stmt.cols_) {
     auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
     col_ids.push_back(idx);
+  }
+  auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
+
+  // The prefix-compressed tree encodes keys of any shape into bytes.
+  if (stmt.index_type_ == BPlusTreePrefixIndex::ACCESS_METHOD) {
+    std::unique_lock<std::shared_mutex> l(catalog_lock_);
+    auto info = catalog_->CreatePrefixIndex(txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_,
+                                            key_schema, col_ids);
+    l.unlock();
+    if (info == nullptr) {
+      throw bustub::Exception("Failed to create index");
+    }
+    WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
+    return;
+  }
+
+  for (auto idx : col_ids) {
     if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
       throw NotImplementedException("only support creating index on integer column");
     }
   }
-  auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
 
   // TODO(spring2023): If you want to support composite index key for leaderboard optimization, remove this assertion
   // and create index with different key type that can hold multiple keys based on number of index columns.
@@ -72,9 +88,15 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   }
 
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-      txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+  IndexInfo *info;
+  if (stmt.index_type_ == BPlusTreePostingIndex::ACCESS_METHOD) {
+    info = catalog_->CreatePostingIndex(txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema,
+                                        col_ids);
+  } else {
+    info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
+        IntegerHashFunctionType{});
+  }
   l.unlock();
 
   if (info == nullptr) {
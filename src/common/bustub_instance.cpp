@@ -33,6 +33,7 @@
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_async.h"
 #include "storage/disk/disk_manager_memory.h"
 #include "type/value_factory.h"
 
@@ -42,19 +43,24 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> st
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t bpm_size, int page_size, bool async_io) {
   enable_logging = false;
+  SetPageSize(page_size);
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  if (async_io) {
+    disk_manager_ = new DiskManagerAsync(db_file_name);
+  } else {
+    disk_manager_ = new DiskManager(db_file_name);
+  }
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
+  // We need more frames for GenerateTestTable to work. Therefore, we default to BUSTUB_INSTANCE_BPM_SIZE instead of
+  // the default buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManager(bpm_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -82,8 +88,9 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t bpm_size, int page_size) {
   enable_logging = false;
+  SetPageSize(page_size);
 
   // Storage related.
   disk_manager_ = new DiskManagerUnlimitedMemory();
@@ -91,10 +98,10 @@ BustubInstance::BustubInstance() {
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
+  // We need more frames for GenerateTestTable to work. Therefore, we default to BUSTUB_INSTANCE_BPM_SIZE instead of
+  // the default buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManager(bpm_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -176,6 +183,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\stats: show buffer pool statistics
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -189,6 +197,42 @@ see the execution plan of your query.
   WriteOneCell(help, writer);
 }
 
+void BustubInstance::CmdDisplayStats(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    WriteOneCell("buffer pool not available", writer);
+    return;
+  }
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto *name : {"shard", "hits", "misses", "hit_ratio", "evictions", "dirty_evictions", "reads", "writes",
+                           "flushes", "read_p99_us", "write_p99_us", "latch_wait_us", "page_latch_wait_us"}) {
+    writer.WriteHeaderCell(name);
+  }
+  writer.EndHeader();
+  auto write_row = [&writer](const std::string &shard, const BufferPoolStats &stats) {
+    writer.BeginRow();
+    writer.WriteCell(shard);
+    writer.WriteCell(fmt::format("{}", stats.hits_));
+    writer.WriteCell(fmt::format("{}", stats.misses_));
+    writer.WriteCell(fmt::format("{:.4f}", stats.HitRatio()));
+    writer.WriteCell(fmt::format("{}", stats.evictions_));
+    writer.WriteCell(fmt::format("{}", stats.dirty_evictions_));
+    writer.WriteCell(fmt::format("{}", stats.reads_));
+    writer.WriteCell(fmt::format("{}", stats.writes_));
+    writer.WriteCell(fmt::format("{}", stats.flushes_));
+    writer.WriteCell(fmt::format("{}", stats.read_latency_.PercentileMicros(99)));
+    writer.WriteCell(fmt::format("{}", stats.write_latency_.PercentileMicros(99)));
+    writer.WriteCell(fmt::format("{}", stats.latch_wait_ns_ / 1000));
+    writer.WriteCell(fmt::format("{}", stats.page_latch_wait_ns_ / 1000));
+    writer.EndRow();
+  };
+  for (size_t i = 0; i < buffer_pool_manager_->GetNumShards(); i++) {
+    write_row(fmt::format("{}", i), buffer_pool_manager_->GetShardStats(i));
+  }
+  write_row("total", buffer_pool_manager_->GetStats());
+  writer.EndTable();
+}
+
 auto BustubInstance::ExecuteSql(const std::string &sql, ResultWriter &writer,
                                 std::shared_ptr<CheckOptions> check_options) -> bool {
   auto txn = txn_manager_->Begin();
@@ -220,6 +264,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayHelp(writer);
       return true;
     }
+    if (sql == "\\stats") {
+      CmdDisplayStats(writer);
+      return true;
+    }
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
 
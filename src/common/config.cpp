@@ -12,6 +12,10 @@
 
 #include "common/config.h"
 
+#include <string>
+
+#include "common/exception.h"
+
 namespace bustub {
 
 std::atomic<bool> enable_logging(false);
@@ -20,4 +24,19 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds background_flush_interval = std::chrono::milliseconds(10);
+
+std::chrono::milliseconds bplustree_compaction_interval = std::chrono::milliseconds(100);
+
+std::chrono::milliseconds table_heap_vacuum_interval = std::chrono::milliseconds(100);
+
+int bustub_page_size = BUSTUB_PAGE_SIZE;
+
+void SetPageSize(int page_size) {
+  if (page_size < BUSTUB_PAGE_SIZE || page_size > BUSTUB_MAX_PAGE_SIZE || (page_size & (page_size - 1)) != 0) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "unsupported page size " + std::to_string(page_size));
+  }
+  bustub_page_size = page_size;
+}
+
 }  // namespace bustub
@@ -503,7 +503,6 @@ auto LockManager::CanLockUpgrade(LockMode curr_lock_mode, LockMode requested_loc
 }
 void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) {
   std::unique_lock<std::mutex> waits_for_lck(waits_for_latch_);
-  for ()
 }
 
 void LockManager::RemoveEdge(txn_id_t t1, txn_id_t t2) {}
@@ -19,21 +19,123 @@ void IndexScanExecutor::Init() {
   index_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
   table_info_ = exec_ctx_->GetCatalog()->GetTable(index_->table_name_);
 
-  auto tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_->index_.get());
-  iterator_ = tree->GetBeginIterator();
+  const Schema &key_schema = index_->key_schema_;
+  auto key_tuple = [&](const Value &value) { return Tuple({value}, &key_schema); };
+
+  auto key_bound = [&](const std::optional<Value> &value,
+                       bool inclusive) -> std::optional<IndexKeyBound<IntegerKeyType>> {
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+    IndexKeyBound<IntegerKeyType> bound;
+    bound.key_.SetFromKey(key_tuple(*value));
+    bound.inclusive_ = inclusive;
+    return bound;
+  };
+
+  posting_index_ = dynamic_cast<BPlusTreePostingIndex *>(index_->index_.get());
+  posting_rids_.clear();
+  posting_pos_ = 0;
+  if (auto *tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_->index_.get()); tree != nullptr) {
+    iterator_ = tree->GetRangeIterator(key_bound(plan_->lower_bound_, plan_->lower_inclusive_),
+                                       key_bound(plan_->upper_bound_, plan_->upper_inclusive_), plan_->reverse_);
+    prefix_iterator_.reset();
+  } else if (posting_index_ != nullptr) {
+    posting_iterator_ =
+        posting_index_->GetRangeIterator(key_bound(plan_->lower_bound_, plan_->lower_inclusive_),
+                                         key_bound(plan_->upper_bound_, plan_->upper_inclusive_), plan_->reverse_);
+    prefix_iterator_.reset();
+  } else {
+    // Prefix tree leaves are only linked forward, and its iterator is unbounded: NextRid checks the upper bound.
+    BUSTUB_ENSURE(!plan_->reverse_, "a prefix_btree index can't be scanned backward");
+    auto *prefix_index = dynamic_cast<BPlusTreePrefixIndex *>(index_->index_.get());
+    if (plan_->lower_bound_.has_value()) {
+      prefix_iterator_ = prefix_index->GetBeginIterator(key_tuple(*plan_->lower_bound_));
+      if (!plan_->lower_inclusive_) {
+        auto lower_key = BPlusTreePrefixIndex::EncodeKey(key_tuple(*plan_->lower_bound_), key_schema);
+        while (!prefix_iterator_->IsEnd() && (**prefix_iterator_).first == lower_key) {
+          ++*prefix_iterator_;
+        }
+      }
+    } else {
+      prefix_iterator_ = prefix_index->GetBeginIterator();
+    }
+    prefix_upper_key_.reset();
+    if (plan_->upper_bound_.has_value()) {
+      prefix_upper_key_ = BPlusTreePrefixIndex::EncodeKey(key_tuple(*plan_->upper_bound_), key_schema);
+    }
+  }
+  batch_.clear();
+  batch_pos_ = 0;
 }
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  while (!iterator_.IsEnd() && table_info_->table_->GetTuple((*iterator_).second).first.is_deleted_) {
-    ++iterator_;
+auto IndexScanExecutor::NextRid(RID *rid) -> bool {
+  if (posting_index_ != nullptr) {
+    // Hand out the RIDs of one key before moving on to the next.
+    while (posting_pos_ == posting_rids_.size()) {
+      if (posting_iterator_.IsEnd()) {
+        return false;
+      }
+      posting_rids_.clear();
+      posting_pos_ = 0;
+      const auto &[key, list] = *posting_iterator_;
+      posting_index_->GetRids(key, list, &posting_rids_);
+      if (plan_->reverse_) {
+        --posting_iterator_;
+      } else {
+        ++posting_iterator_;
+      }
+    }
+    *rid = posting_rids_[posting_pos_++];
+    return true;
+  }
+  if (prefix_iterator_.has_value()) {
+    if (prefix_iterator_->IsEnd()) {
+      return false;
+    }
+    auto [key, next_rid] = **prefix_iterator_;
+    if (prefix_upper_key_.has_value() &&
+        (key > *prefix_upper_key_ || (key == *prefix_upper_key_ && !plan_->upper_inclusive_))) {
+      return false;
+    }
+    *rid = next_rid;
+    ++*prefix_iterator_;
+    return true;
   }
   if (iterator_.IsEnd()) {
     return false;
   }
   *rid = (*iterator_).second;
-  *tuple = table_info_->table_->GetTuple(*rid).second;
-  ++iterator_;
+  if (plan_->reverse_) {
+    --iterator_;
+  } else {
+    ++iterator_;
+  }
   return true;
 }
 
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (batch_pos_ == batch_.size()) {
+      // Read the next rids from the index and fetch the pages of their tuples together.
+      std::vector<RID> rids;
+      RID next_rid;
+      while (rids.size() < static_cast<size_t>(INDEX_SCAN_BATCH_SIZE) && NextRid(&next_rid)) {
+        rids.push_back(next_rid);
+      }
+      if (rids.empty()) {
+        return false;
+      }
+      batch_ = table_info_->table_->GetTuples(rids);
+      batch_pos_ = 0;
+    }
+    auto &[meta, batch_tuple] = batch_[batch_pos_++];
+    if (!meta.is_deleted_) {
+      *rid = batch_tuple.GetRid();
+      *tuple = std::move(batch_tuple);
+      return true;
+    }
+  }
+}
+
 }  // namespace bustub
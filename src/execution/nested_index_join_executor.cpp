@@ -11,20 +11,103 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  results_.clear();
+  results_pos_ = 0;
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (results_pos_ == results_.size()) {
+    if (!JoinBatch()) {
+      return false;
+    }
+  }
+  *tuple = std::move(results_[results_pos_++]);
+  return true;
+}
+
+auto NestIndexJoinExecutor::JoinBatch() -> bool {
+  results_.clear();
+  results_pos_ = 0;
+
+  std::vector<Tuple> outer_tuples;
+  Tuple outer_tuple;
+  RID outer_rid;
+  while (outer_tuples.size() < static_cast<size_t>(INDEX_JOIN_BATCH_SIZE) &&
+         child_executor_->Next(&outer_tuple, &outer_rid)) {
+    outer_tuples.push_back(std::move(outer_tuple));
+  }
+  if (outer_tuples.empty()) {
+    return false;
+  }
+
+  // A null key matches nothing, so only the other outer tuples probe the index.
+  std::vector<Tuple> keys;
+  std::vector<size_t> probing;
+  for (size_t i = 0; i < outer_tuples.size(); i++) {
+    auto key = plan_->KeyPredicate()->Evaluate(&outer_tuples[i], child_executor_->GetOutputSchema());
+    if (!key.IsNull()) {
+      keys.emplace_back(std::vector<Value>{key}, &index_info_->key_schema_);
+      probing.push_back(i);
+    }
+  }
+  std::vector<std::vector<RID>> probe_rids;
+  index_info_->index_->ScanKeys(keys, &probe_rids, exec_ctx_->GetTransaction());
+
+  std::vector<std::vector<RID>> matches(outer_tuples.size());
+  std::vector<RID> inner_rids;
+  for (size_t i = 0; i < probing.size(); i++) {
+    matches[probing[i]] = std::move(probe_rids[i]);
+    inner_rids.insert(inner_rids.end(), matches[probing[i]].begin(), matches[probing[i]].end());
+  }
+  auto inner_tuples = table_info_->table_->GetTuples(inner_rids);
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+  size_t inner_pos = 0;
+  for (size_t i = 0; i < outer_tuples.size(); i++) {
+    bool matched = false;
+    for (size_t j = 0; j < matches[i].size(); j++) {
+      const auto &[meta, inner_tuple] = inner_tuples[inner_pos++];
+      if (!meta.is_deleted_) {
+        PutResult(outer_tuples[i], &inner_tuple);
+        matched = true;
+      }
+    }
+    if (!matched && plan_->GetJoinType() == JoinType::LEFT) {
+      PutResult(outer_tuples[i], nullptr);
+    }
+  }
+  return true;
+}
+
+void NestIndexJoinExecutor::PutResult(const Tuple &outer_tuple, const Tuple *inner_tuple) {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(outer_schema.GetColumnCount() + inner_schema.GetColumnCount());
+  for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+    values.emplace_back(outer_tuple.GetValue(&outer_schema, i));
+  }
+  for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+    values.emplace_back(inner_tuple != nullptr ? inner_tuple->GetValue(&inner_schema, i)
+                                               : ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+  }
+  results_.emplace_back(values, &GetOutputSchema());
+}
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 
 #include "common/config.h"
 #include "execution/executors/update_executor.h"
+#include "execution/expressions/column_value_expression.h"
 
 namespace bustub {
 
@@ -26,6 +27,20 @@ void UpdateExecutor::Init() {
   child_executor_->Init();
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
   index_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  // A key column whose target expression is the column itself keeps its value, e.g. in `SET v = v + 1` for an index
+  // on k.
+  key_updated_.clear();
+  for (auto &index : index_) {
+    bool key_updated = false;
+    for (auto attr : index->index_->GetKeyAttrs()) {
+      const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(plan_->target_expressions_[attr].get());
+      if (column_expr == nullptr || column_expr->GetTupleIdx() != 0 || column_expr->GetColIdx() != attr) {
+        key_updated = true;
+      }
+    }
+    key_updated_.push_back(key_updated);
+  }
+  moved_rids_.clear();
   row_count_ = 0;
   has_exec_ = false;
 }
@@ -36,35 +51,31 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   row_count_ = 0;
   auto *transaction = new Transaction(0);
   while (child_executor_->Next(&child_tuple, &child_rid)) {
-    // 从表中删除老数据,这里不确定是新建一个meta还是拿老的meta改
-    auto tuple_meta = table_info_->table_->GetTupleMeta(child_rid);
-    tuple_meta.is_deleted_ = true;
-    table_info_->table_->UpdateTupleMeta(tuple_meta, child_rid);
-
-    // 从索引中删除老数据
-    for (auto &index : index_) {
-      auto new_key = child_tuple.KeyFromTuple(table_info_->schema_, *(index->index_->GetKeySchema()),
-                                              index->index_->GetKeyAttrs());
-      index->index_->DeleteEntry(new_key, child_rid, transaction);
+    if (moved_rids_.count(child_rid) != 0) {
+      continue;
     }
-
     // 通过表达式计算出新的values
-    std::vector<Value> insert_values;
+    std::vector<Value> update_values;
     for (auto &expr : plan_->target_expressions_) {
-      insert_values.emplace_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+      update_values.emplace_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
     }
-    // 插入新的tuple
-    Tuple insert_tuple{std::move(insert_values), &child_executor_->GetOutputSchema()};
-    auto inserted_rid = table_info_->table_->InsertTuple({INVALID_TXN_ID, INVALID_TXN_ID, false}, insert_tuple);
-    if (inserted_rid == std::nullopt) {
-      delete transaction;
-      return false;
+    Tuple update_tuple{std::move(update_values), &child_executor_->GetOutputSchema()};
+    auto tuple_meta = table_info_->table_->GetTupleMeta(child_rid);
+    auto updated_rid = table_info_->table_->UpdateTuple(tuple_meta, update_tuple, child_rid);
+    if (!(updated_rid == child_rid)) {
+      moved_rids_.insert(updated_rid);
     }
+
     // 同步索引
-    for (auto &index : index_) {
-      auto new_key = insert_tuple.KeyFromTuple(table_info_->schema_, *(index->index_->GetKeySchema()),
-                                               index->index_->GetKeyAttrs());
-      index->index_->InsertEntry(new_key, *inserted_rid, transaction);
+    for (size_t i = 0; i < index_.size(); i++) {
+      if (!key_updated_[i] && updated_rid == child_rid) {
+        continue;
+      }
+      auto *index = index_[i]->index_.get();
+      auto old_key = child_tuple.KeyFromTuple(table_info_->schema_, *index->GetKeySchema(), index->GetKeyAttrs());
+      index->DeleteEntry(old_key, child_rid, transaction);
+      auto new_key = update_tuple.KeyFromTuple(table_info_->schema_, *index->GetKeySchema(), index->GetKeyAttrs());
+      index->InsertEntry(new_key, updated_rid, transaction);
     }
     row_count_++;
   }
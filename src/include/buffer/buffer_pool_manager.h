@@ -12,12 +12,19 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <limits>
 #include <list>
 #include <memory>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
 
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/frame_arena.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
 #include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -27,8 +34,57 @@
 
 namespace bustub {
 
+/**
+ * BufferPoolShard is one independent partition of the buffer pool. Every page id is mapped to exactly one shard, and
+ * the shard owns a contiguous range of frames together with its own page table, free list and replacer. Frame ids
+ * inside a shard are local to that shard (0 .. num_frames_ - 1).
+ */
+struct BufferPoolShard {
+  BufferPoolShard(Page *frames, size_t num_frames, size_t replacer_k, size_t scan_ring_size)
+      : frames_(frames),
+        num_frames_(num_frames),
+        page_table_(num_frames),
+        replacer_(std::make_unique<LRUKReplacer>(num_frames, replacer_k, scan_ring_size)) {
+    for (size_t i = 0; i < num_frames_; ++i) {
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+  }
+
+  /** The first frame owned by this shard. */
+  Page *frames_;
+  /** Number of frames owned by this shard. */
+  const size_t num_frames_;
+  /**
+   * Page table for keeping track of the pages resident in this shard. Modified under latch_, but looked up without it
+   * when pinning and unpinning resident pages. A page only enters it once its frame holds the page's contents.
+   */
+  PageTable page_table_;
+  /** Replacer to find unpinned frames of this shard for replacement. */
+  std::unique_ptr<LRUKReplacer> replacer_;
+  /** List of free frames of this shard that don't have any pages on them. */
+  std::list<frame_id_t> free_list_;
+  /**
+   * Pages with disk I/O in flight: either being read into a frame, or being written back after their frame was picked
+   * as a victim. Anyone touching such a page waits on io_cv_ until the I/O finishes.
+   */
+  std::unordered_set<page_id_t> io_pending_;
+  /** Protects every member above. Never held across disk I/O. */
+  std::mutex latch_;
+  /** Signalled whenever a page leaves io_pending_. */
+  std::condition_variable io_cv_;
+  /** Hit, eviction, I/O and latch wait counters of this shard. Updated without latch_. */
+  BufferPoolCounters stats_;
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * The pool can be split into several shards. A page always lives in the shard selected by hashing its page id, so
+ * threads working on pages of different shards never contend on the same latch.
+ *
+ * Pinning and unpinning a page that is already resident takes no shard latch at all: the frame is found in the
+ * lock-free page table and pinned with an atomic increment of its pin count. Evicting or deleting a page therefore
+ * first claims its frame by swapping a zero pin count for FRAME_CLAIMED, which makes concurrent pin attempts back off.
  */
 class BufferPoolManager {
  public:
@@ -38,9 +94,11 @@ class BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param num_shards the number of independent shards the frames are partitioned into
+   * @param bind_numa_nodes if true, the frames of shard i are placed on NUMA node i % (number of nodes)
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, size_t num_shards = 1, bool bind_numa_nodes = false);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
@@ -50,9 +108,21 @@ class BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
+  /** @brief Return the number of shards of the buffer pool. */
+  auto GetNumShards() -> size_t { return shards_.size(); }
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /** @brief Return the counters of the whole buffer pool, summed over its shards. */
+  auto GetStats() -> BufferPoolStats;
+
+  /** @brief Return the counters of one shard. */
+  auto GetShardStats(size_t shard) -> BufferPoolStats { return shards_[shard]->stats_.GetSnapshot(); }
+
+  /** @brief Zero the counters of every shard, e.g. once a benchmark has finished loading its data. */
+  void ResetStats();
+
   /**
    * TODO(P1): Add implementation
    *
@@ -100,8 +170,11 @@ class BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
+   * Pages fetched with AccessType::Scan are confined to a small ring of frames per shard (SCAN_RING_SIZE in total) and
+   * never promoted in the replacer, so sequential scans don't evict the working set.
+   *
    * @param page_id id of page to be fetched
-   * @param access_type type of access to the page, only needed for leaderboard tests.
+   * @param access_type type of access to the page
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
   auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
@@ -117,11 +190,61 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
+
+  /**
+   * @brief Read latch page_id if it still sits in frame, without looking it up in the page table. For callers that keep
+   * coming back to the same hot page, like the root of a B+ tree, and remember where they last found it.
+   *
+   * @param frame the frame page_id was in, as returned by FetchPage; may be stale
+   * @param page_id id of the page to be fetched
+   * @param access_type type of access to the page
+   * @return the read latched page, or an invalid guard if the frame holds another page by now
+   */
+  auto FetchPageReadInFrame(Page *frame, page_id_t page_id, AccessType access_type = AccessType::Unknown)
+      -> ReadPageGuard;
+
+  /**
+   * @brief Fetch several pages at once. Behaves like calling FetchPage on every page id, but pins the resident pages of
+   * each shard under a single latch acquisition, and reads the missing pages together: runs of consecutive page ids
+   * become a single vectored read, and all reads and write-backs are in flight at the same time.
+   *
+   * @param page_ids ids of the pages to be fetched, a page id that occurs several times is pinned as often
+   * @param access_type type of access to the pages
+   * @return one entry per page id, nullptr where the page could not be fetched (see FetchPage)
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *>;
+
+  /**
+   * @brief PageGuard wrappers for FetchPages. The pages are read latched in the order of page_ids, so a page id must
+   * not occur twice in a call to FetchPagesRead.
+   */
+  auto FetchPagesBasic(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<BasicPageGuard>;
+  auto FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<ReadPageGuard>;
+
+  /**
+   * @brief Start reading page_id into the buffer pool in the background, as if by a scan, and return immediately.
+   *
+   * The page is not pinned. A later FetchPage of it waits for the read to finish instead of issuing its own. Nothing
+   * happens if the page is already resident or on its way, or if there is neither a free frame nor a clean frame of the
+   * scan ring to read it into.
+   *
+   * An asynchronous read completes on a thread of the disk manager, which must not wait for a shard latch: a thread
+   * holding it may be waiting for that very thread. A thread of the buffer pool, started by the first such read,
+   * publishes the page. A read that completes inline is published before PrefetchPage returns.
+   *
+   * @param page_id id of page to be prefetched
+   * @return true if a read was issued
+   */
+  auto PrefetchPage(page_id_t page_id) -> bool;
 
   /**
    * TODO(P1): Add implementation
@@ -174,47 +297,179 @@ class BufferPoolManager {
    */
   auto DeletePage(page_id_t page_id) -> bool;
 
+  /**
+   * @brief Start a background thread that writes back dirty unpinned pages ahead of eviction.
+   *
+   * Every background_flush_interval (or sooner, when a fetch had to write back a dirty victim) the flusher looks at
+   * the next clean_ratio * evictable frames the replacer would evict in each shard and writes back the dirty ones, in
+   * page id order and as a single batch of asynchronous writes. While the flusher runs, eviction prefers clean frames,
+   * so that fetches rarely have to wait for a write-back.
+   *
+   * @param clean_ratio the fraction of evictable frames of each shard to keep clean, in (0, 1]
+   */
+  void StartBackgroundFlush(double clean_ratio = BACKGROUND_FLUSH_CLEAN_RATIO);
+
+  /** @brief Stop the background flusher and wait for it to exit. Does nothing if it is not running. */
+  void StopBackgroundFlush();
+
  private:
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
 
+  /** Owns the frames: the page headers and the (huge page backed) page data. */
+  std::unique_ptr<FrameArena> arena_;
   /** Array of buffer pool pages. Indexed by Frame id*/
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** The shards of the buffer pool. Each shard owns a contiguous slice of pages_. */
+  std::vector<std::unique_ptr<BufferPoolShard>> shards_;
 
+  /** Protects free_page_id_. Page ids are allocated across all shards, so this is separate from the shard latches. */
+  std::mutex page_id_latch_;
   std::list<page_id_t> free_page_id_;
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
     // This is a no-nop right now without a more complex data structure to track deallocated pages
+    std::scoped_lock lock(page_id_latch_);
     free_page_id_.push_back(page_id);
   }
 
-  // TODO(student): You may add additional private members and helper functions
+  /** @return the shard responsible for page_id */
+  auto GetShard(page_id_t page_id) -> BufferPoolShard & { return *shards_[static_cast<size_t>(page_id) % shards_.size()]; }
+
+  /**
+   * @brief Wait until no disk I/O is in flight for page_id. Caller must hold the shard latch through `lock`.
+   */
+  static void WaitForIO(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id);
+
+  /**
+   * @brief Acquire the shard latch, counting the time spent waiting if another thread holds it.
+   * @return the held latch
+   */
+  static auto LockShard(BufferPoolShard &shard) -> std::unique_lock<std::mutex>;
+  /** @brief Re-acquire a released shard latch, counting the time spent waiting. */
+  static void RelockShard(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock);
+  /** @brief Latch a fetched page for reading or writing, counting the time spent waiting. */
+  void LatchPage(Page *page, bool exclusive);
+
+  /** Pin count of a frame while it is being evicted or deleted, low enough to stay negative under concurrent pins. */
+  static constexpr int FRAME_CLAIMED = std::numeric_limits<int>::min() / 2;
+
+  /**
+   * @brief Claim an unpinned frame for eviction or deletion. Caller must hold the shard latch.
+   * @return true if the frame was unpinned and is now claimed
+   */
+  static auto TryClaimFrame(Page &page) -> bool;
+  /** @brief Give up the claim on a frame, leaving pin_count pins on it. */
+  static void ReleaseClaim(Page &page, int pin_count);
+
+  /**
+   * @brief Pin page_id without the shard latch if it is resident.
+   * @return the pinned page, or nullptr if the caller has to take the slow path
+   */
+  auto TryPinResident(BufferPoolShard &shard, page_id_t page_id, AccessType access_type) -> Page *;
+  /** @brief Pin page_id without the shard latch if it is in the frame. @return the pinned page, or nullptr */
+  auto TryPinFrame(BufferPoolShard &shard, frame_id_t frame_id, page_id_t page_id, AccessType access_type) -> Page *;
+  /** @brief Undo a pin TryPinResident took on a frame that turned out to hold another page. */
+  void DropStalePin(BufferPoolShard &shard, frame_id_t frame_id);
+
+  /**
+   * @brief Take a frame of the shard and pin it: a free frame, or else a victim, which leaves the page table. Caller
+   * must hold the shard latch.
+   * @param[out] victim_page_id the dirty page the frame held, which must be written back before the frame is reused, or
+   * INVALID_PAGE_ID
+   * @return the frame, or -1 if every frame of the shard is pinned
+   */
+  auto TakeFrame(BufferPoolShard &shard, AccessType access_type, page_id_t *victim_page_id) -> frame_id_t;
+
+  /** A page FetchPages reads into a frame taken for it, and the dirty victim of the frame, both pending. */
+  struct FrameLoad {
+    BufferPoolShard *shard_;
+    page_id_t page_id_;
+    frame_id_t frame_id_{-1};
+    page_id_t victim_page_id_{INVALID_PAGE_ID};
+    /** The copy of the victim that is written back. */
+    const char *victim_copy_{nullptr};
+    bool read_failed_{false};
+    bool write_failed_{false};
+  };
+  /** @brief Do the disk I/O of the loads without any latch held, then publish the pages. */
+  void LoadFrames(std::vector<FrameLoad> *loads);
+
+  /**
+   * @brief Bind page_id to a pinned frame of the shard, writing back the dirty victim and (optionally) reading the
+   * page from disk. Caller must hold the shard latch through `lock`; the latch is released during disk I/O and
+   * re-acquired before returning.
+   * @return the pinned page, or nullptr if every frame of the shard is pinned or the page could not be read
+   */
+  auto AllocateFrame(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id, bool read_page,
+                     AccessType access_type = AccessType::Unknown) -> Page *;
+  /**
+   * @brief Put a pinned frame that no page could be read into back on the free list, dropping the pin. Caller must
+   * hold the shard latch.
+   */
+  void ReturnFrame(BufferPoolShard &shard, frame_id_t frame_id);
+  /**
+   * @brief Put a victim whose write-back failed back into its pinned frame, as a dirty page, dropping the pin. Caller
+   * must hold the shard latch.
+   * @param victim_copy the contents of the victim, or nullptr if the frame still holds them
+   */
+  void RestoreVictim(BufferPoolShard &shard, frame_id_t frame_id, page_id_t victim_page_id, const char *victim_copy);
+  /**
+   * @brief Write a resident page to disk. Caller must hold the shard latch through `lock`; like in AllocateFrame, the
+   * latch is released during the write, while the page is pinned and pending.
+   * @return false if the page is not resident
+   */
+  auto FlushPageNoLock(BufferPoolShard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id) -> bool;
+
+  /** A prefetch whose read finished, for the prefetch thread to publish. */
+  struct PrefetchDone {
+    BufferPoolShard *shard_;
+    page_id_t page_id_;
+    frame_id_t frame_id_;
+    bool success_;
+  };
+  /** Main loop of the prefetch thread. */
+  void RunPrefetchPublisher();
+  /** Put a prefetched page in the page table, or return its frame if the read failed. */
+  void PublishPrefetch(const PrefetchDone &done);
+  void StopPrefetchPublisher();
+
+  /** Main loop of the background flusher thread. */
+  void RunBackgroundFlush();
+  /** Write back the dirty pages among the next victims of the shard, see StartBackgroundFlush. */
+  void FlushShardInBackground(BufferPoolShard &shard);
+
+  /** True while the background flusher should keep running. */
+  std::atomic<bool> enable_background_flush_{false};
+  /** Set by eviction of a dirty victim to wake the flusher before its interval expires. */
+  std::atomic<bool> background_flush_requested_{false};
+  double background_flush_clean_ratio_{BACKGROUND_FLUSH_CLEAN_RATIO};
+  std::thread *background_flush_thread_{nullptr};
+  std::mutex background_flush_latch_;
+  std::condition_variable background_flush_cv_;
 
-  auto AllocateFrame(page_id_t page_id, frame_id_t *frame_id) -> bool;
-  auto FlushPageNoLock(page_id_t page_id) -> bool;
+  std::once_flag prefetch_thread_started_;
+  std::thread *prefetch_thread_{nullptr};
+  /** Latched by disk manager threads, only ever for a push, so that they never wait for long. */
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  std::vector<PrefetchDone> prefetch_done_; /* protected by prefetch_latch_ */
+  bool stop_prefetch_thread_{false};        /* protected by prefetch_latch_ */
 };
 }  // namespace bustub
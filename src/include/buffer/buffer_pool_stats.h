@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+namespace bustub {
+
+/**
+ * LatencyHistogram counts latencies in power-of-two buckets of microseconds: bucket 0 holds latencies below 1us, and
+ * bucket i > 0 holds latencies in [2^(i-1), 2^i) us. The last bucket is open-ended.
+ *
+ * Recording is a pair of relaxed atomic increments, so it can be done from any thread, including I/O completions.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t NUM_BUCKETS = 32;
+
+  /** A plain copy of the histogram at one point in time. */
+  struct Snapshot {
+    std::array<uint64_t, NUM_BUCKETS> buckets_{};
+    uint64_t count_{0};
+    uint64_t total_ns_{0};
+
+    auto operator+=(const Snapshot &other) -> Snapshot &;
+    /** @return the mean latency in microseconds, 0 if nothing was recorded */
+    auto MeanMicros() const -> double;
+    /** @return an upper bound on the given percentile (in [0, 100]) in microseconds, 0 if nothing was recorded */
+    auto PercentileMicros(double percentile) const -> uint64_t;
+    auto ToJson() const -> std::string;
+  };
+
+  void Record(std::chrono::nanoseconds latency);
+  auto GetSnapshot() const -> Snapshot;
+  void Reset();
+
+  /** @return the bucket a latency of the given number of microseconds falls into */
+  static auto BucketOf(uint64_t micros) -> size_t;
+
+ private:
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+  std::atomic<uint64_t> total_ns_{0};
+};
+
+/**
+ * BufferPoolStats is a plain copy of the counters of a buffer pool shard, or the sum of them over several shards.
+ */
+struct BufferPoolStats {
+  /** Fetches of a page that was already resident. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages pushed out of the pool to make room for another one. */
+  uint64_t evictions_{0};
+  /** Evictions that had to write the victim back first. */
+  uint64_t dirty_evictions_{0};
+  /** Pages read from disk, by fetches and prefetches. */
+  uint64_t reads_{0};
+  /** Pages written to disk, by evictions and flushes. */
+  uint64_t writes_{0};
+  /** Pages written by FlushPage, FlushAllPages and the background flusher. */
+  uint64_t flushes_{0};
+  /** Time spent waiting for a shard latch held by another thread. */
+  uint64_t latch_wait_ns_{0};
+  /** Time spent waiting for a page latch held by another thread. */
+  uint64_t page_latch_wait_ns_{0};
+  LatencyHistogram::Snapshot read_latency_;
+  LatencyHistogram::Snapshot write_latency_;
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats &;
+  /** @return hits / (hits + misses), 0 if there was no fetch */
+  auto HitRatio() const -> double;
+  auto ToJson() const -> std::string;
+};
+
+/**
+ * BufferPoolCounters are the live counters behind BufferPoolStats. Every shard owns one set; they sit on their own
+ * cache lines so that counting doesn't slow down the shard's other members.
+ */
+struct alignas(64) BufferPoolCounters {
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> dirty_evictions_{0};
+  std::atomic<uint64_t> reads_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<uint64_t> flushes_{0};
+  std::atomic<uint64_t> latch_wait_ns_{0};
+  std::atomic<uint64_t> page_latch_wait_ns_{0};
+  LatencyHistogram read_latency_;
+  LatencyHistogram write_latency_;
+
+  /** @brief Bump a counter. Counters are statistics only, so no ordering is needed. */
+  static void Add(std::atomic<uint64_t> &counter, uint64_t value = 1) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  auto GetSnapshot() const -> BufferPoolStats;
+  void Reset();
+};
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * FrameArena owns the frames of a buffer pool: an array of Page headers, and one contiguous region holding the data
+ * of all frames back to back.
+ *
+ * The data region is mapped with mmap, backed by 1GB or 2MB huge pages when the system has them reserved, and by
+ * transparent huge pages otherwise, so that walking the buffer pool costs few TLB entries. Frame data is aligned to
+ * the page size and never shares a cacheline with another frame or with the Page headers.
+ *
+ * The data region is not touched until a frame is first used, so slices of it can still be bound to a NUMA node with
+ * BindToNode after construction.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Map a new arena.
+   * @param num_frames number of frames
+   * @param page_size size of the data of a frame in bytes
+   */
+  FrameArena(size_t num_frames, size_t page_size);
+
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the Page headers of the frames, indexed by frame id */
+  auto GetFrames() -> Page * { return frames_; }
+
+  /** @return the size of the pages backing the data region, e.g. 2MB if it is on 2MB huge pages */
+  auto GetMappingPageSize() const -> size_t { return mapping_page_size_; }
+
+  /**
+   * @brief Ask the kernel to place the data of frames [first_frame, first_frame + num_frames) on NUMA node node.
+   *
+   * Only the part of the range covering whole pages of the mapping is bound. Must be called before the frames are
+   * first used.
+   *
+   * @return true if the range was bound
+   */
+  auto BindToNode(size_t first_frame, size_t num_frames, int node) -> bool;
+
+  /** @return the number of NUMA nodes of this machine, 1 if unknown */
+  static auto NumNumaNodes() -> int;
+
+ private:
+  /** Map the data region, trying the largest huge pages first. */
+  void MapData();
+
+  size_t num_frames_;
+  size_t page_size_;
+  Page *frames_{nullptr};
+  char *data_{nullptr};
+  /** Size of the mapping, rounded up to mapping_page_size_. */
+  size_t data_size_{0};
+  size_t mapping_page_size_{0};
+};
+
+}  // namespace bustub
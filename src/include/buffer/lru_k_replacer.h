@@ -12,10 +12,11 @@
 
 #pragma once
 
+#include <functional>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
@@ -27,13 +28,20 @@ enum class AccessType { Unknown = 0, Get, Scan };
 
 class LRUKNode {
  public:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-
-  std::list<size_t> history_;
-  size_t k_;
+  /** Ring buffer of the last K access timestamps. Once it is full, history_[head_] is the least recent one. */
+  std::vector<size_t> history_;
+  /** Slot of history_ overwritten by the next access. */
+  size_t head_{0};
+  /** Number of accesses recorded so far, capped at K. */
+  size_t count_{0};
+  /** Eviction key: the earliest access while count_ < K, otherwise the K-th most recent access. */
+  size_t k_{0};
   frame_id_t fid_;
   bool is_evictable_{false};
+  /** True if the replacer is tracking this frame. */
+  bool in_use_{false};
+  /** True if the frame has only been accessed by scans. Its key is then the most recent scan access. */
+  bool scan_only_{false};
 };
 
 /**
@@ -46,6 +54,15 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Evictable frames are kept in two ordered sets, one for +inf frames keyed by their first access and one for the
+ * others keyed by their k-th most recent access, so the victim is always the first element of one of the sets.
+ * Evict, RecordAccess, SetEvictable and Remove take O(log n).
+ *
+ * With a non-zero scan ring size, frames brought in by AccessType::Scan are kept apart from the LRU-K history, like
+ * PostgreSQL's buffer ring strategy: a scan access never promotes a frame, and once scan_ring_size frames touched only
+ * by scans are evictable, they are recycled before any other frame. A large sequential scan therefore reuses a small
+ * ring of frames instead of flushing the working set out of the pool.
  */
 class LRUKReplacer {
  public:
@@ -55,8 +72,10 @@ class LRUKReplacer {
    *
    * @brief a new LRUKReplacer.
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
+   * @param scan_ring_size the number of frames scans may hold before recycling their own, 0 to treat scans like any
+   * other access
    */
-  explicit LRUKReplacer(size_t num_frames, size_t k);
+  explicit LRUKReplacer(size_t num_frames, size_t k, size_t scan_ring_size = 0);
 
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
@@ -85,6 +104,39 @@ class LRUKReplacer {
    */
   auto Evict(frame_id_t *frame_id) -> bool;
 
+  /**
+   * @brief Like Evict, but only frames accepted by filter are candidates. Frames rejected by the filter are skipped
+   * as if they were not evictable. Only the next max_candidates victims are offered to the filter, so that an eviction
+   * never walks the queues under the latch.
+   *
+   * @param[out] frame_id id of frame that is evicted.
+   * @param filter predicate deciding whether a frame may be evicted.
+   * @param max_candidates how many of the next victims may be offered to the filter.
+   * @return true if a frame is evicted successfully, false if none of the candidates can be evicted.
+   */
+  auto Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &filter,
+             size_t max_candidates = LRUK_EVICT_CANDIDATES) -> bool;
+
+  /**
+   * @brief Like Evict with a filter, but only frames that have been accessed by scans alone are candidates, oldest
+   * first. Used to recycle the scan ring without touching any other frame.
+   *
+   * @param[out] frame_id id of frame that is evicted.
+   * @param filter predicate deciding whether a frame may be evicted.
+   * @param max_candidates how many of the oldest scan frames may be offered to the filter.
+   * @return true if a frame is evicted successfully, false if none of the candidates can be evicted.
+   */
+  auto EvictScanFrame(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &filter,
+                      size_t max_candidates = LRUK_EVICT_CANDIDATES) -> bool;
+
+  /**
+   * @brief Return up to count evictable frames in the order Evict would pick them, without evicting anything.
+   *
+   * @param count maximum number of frames to return.
+   * @return the frames that would be evicted next, best victim first.
+   */
+  auto PeekVictims(size_t count) -> std::vector<frame_id_t>;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -148,12 +200,37 @@ class LRUKReplacer {
   auto Size() -> size_t;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  std::unordered_map<frame_id_t, LRUKNode> node_store_;
+  using VictimQueue = std::set<std::pair<size_t, frame_id_t>>;
+
+  /** @return the node of frame_id, aborting if frame_id is out of range */
+  auto GetNode(frame_id_t frame_id) -> LRUKNode &;
+  /** @return the queue an evictable node belongs in */
+  auto QueueOf(const LRUKNode &node) -> VictimQueue & {
+    if (node.scan_only_) {
+      return scan_queue_;
+    }
+    return node.count_ < k_ ? inf_queue_ : kdist_queue_;
+  }
+  /**
+   * Call visit on evictable frames in the order they should be evicted, until it returns false. Caller must hold
+   * latch_.
+   */
+  void VisitVictims(const std::function<bool(frame_id_t)> &visit);
+  /** Stop tracking node, dropping its history. Caller must hold latch_. */
+  void RemoveNode(LRUKNode &node);
+
+  /** Indexed by frame id. */
+  std::vector<LRUKNode> node_store_;
+  /** Evictable frames with less than k accesses, ordered by their earliest access. */
+  VictimQueue inf_queue_;
+  /** Evictable frames with k accesses, ordered by their k-th most recent access. */
+  VictimQueue kdist_queue_;
+  /** Evictable frames only accessed by scans, ordered by their most recent access. */
+  VictimQueue scan_queue_;
+  size_t scan_ring_size_;
   size_t current_timestamp_{0};
   size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
+  size_t replacer_size_;
   size_t k_;
   std::mutex latch_;
 };
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of the pages resident in a buffer pool shard to their frames.
+ *
+ * It is an open-addressing hash table with linear probing, sized for the frames of the shard so that it never fills up.
+ * Every slot is a single 64-bit atomic word holding both the page id and the frame id, so a slot is always read as a
+ * consistent pair without any latch.
+ *
+ * Insert and Erase must be serialized by the caller (the shard latch). Find may run concurrently with them. A
+ * concurrent Find never returns a mapping that was never in the table, but it may return one that was just erased, or
+ * miss one that Erase is moving to fill a hole. Lock-free callers must therefore validate what they find, and fall back
+ * to a lookup under the shard latch on a miss.
+ */
+class PageTable {
+ public:
+  /** @param num_frames the maximum number of entries the table will hold */
+  explicit PageTable(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * @brief Look up the frame holding page_id.
+   * @param[out] frame_id the frame holding page_id
+   * @return true if page_id was found
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /** @brief Map page_id to frame_id, replacing any previous mapping of page_id. */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of page_id.
+   * @return true if page_id was in the table
+   */
+  auto Erase(page_id_t page_id) -> bool;
+
+  /** @brief Call visit on every entry of the table. Caller must hold the latch serializing writers. */
+  void ForEach(const std::function<void(page_id_t, frame_id_t)> &visit) const;
+
+  /** @return the number of entries. Caller must hold the latch serializing writers. */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static auto Pack(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto FrameOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the slot page_id is probed from */
+  auto Home(page_id_t page_id) const -> size_t;
+  /** @return the slot holding page_id, or the empty slot ending its probe sequence. Caller must be a writer. */
+  auto Locate(page_id_t page_id) const -> size_t;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  /** Number of slots, a power of two. */
+  size_t capacity_;
+  size_t size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// scan_prefetcher.h
+//
+// Identification: src/include/buffer/scan_prefetcher.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <utility>
+
+#include "common/config.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * ScanPrefetcher keeps a readahead window of pages in flight ahead of a scan walking a chain of pages, such as the
+ * pages of a TableHeap or the leaves of a B+ tree.
+ *
+ * The chain can only be followed by reading the pages themselves, so the window grows from its far end: every time the
+ * scan moves to another page, the prefetcher reads the next page id out of the last page of the window (which was
+ * prefetched several steps earlier and is usually resident by now) and prefetches that page.
+ */
+class ScanPrefetcher {
+ public:
+  /** Extracts the id of the next page in the chain from the data of a page, INVALID_PAGE_ID at the end. */
+  using NextPageFn = std::function<page_id_t(const char *page_data)>;
+
+  ScanPrefetcher() = default;
+
+  /**
+   * @param bpm the buffer pool to prefetch into
+   * @param depth the number of pages to keep in flight ahead of the scan, 0 disables readahead
+   * @param next_page how to follow the chain
+   */
+  ScanPrefetcher(BufferPoolManager *bpm, size_t depth, NextPageFn next_page)
+      : bpm_(bpm), depth_(depth), next_page_(std::move(next_page)) {}
+
+  /**
+   * @brief Tell the prefetcher that the scan is now on page_id, and top up the readahead window.
+   *
+   * Must not be called while holding a latch on a page of the chain.
+   */
+  void Advance(page_id_t page_id);
+
+ private:
+  BufferPoolManager *bpm_{nullptr};
+  size_t depth_{0};
+  NextPageFn next_page_;
+  /** The page the scan is on. */
+  page_id_t current_{INVALID_PAGE_ID};
+  /** The pages prefetched ahead of current_, in chain order. */
+  std::deque<page_id_t> window_;
+};
+
+}  // namespace bustub
@@ -24,6 +24,8 @@
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/posting_b_plus_tree_index.h"
+#include "storage/index/prefix_b_plus_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -137,6 +139,8 @@ class Catalog {
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
       table = std::make_unique<TableHeap>(bpm_);
+      // Deleted and moved tuples are reclaimed in the background; the heap stops its vacuum when it is destroyed.
+      table->StartBackgroundVacuum();
     }
 
     // Fetch the table OID for the new table
@@ -228,26 +232,92 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, building the tree bottom-up rather than key by key
+    auto *table_meta = GetTable(table_name);
+    std::vector<std::pair<KeyType, ValueType>> entries;
+    for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+      auto [meta, tuple] = iter.GetTuple();
+      KeyType index_key;
+      index_key.SetFromKey(tuple.KeyFromTuple(schema, key_schema, key_attrs));
+      entries.emplace_back(index_key, tuple.GetRid());
+    }
+    index->BulkLoad(&entries);
+
+    return RegisterIndex(std::move(index), key_schema, index_name, table_name, keysize);
+  }
+
+  /**
+   * Create a new prefix-compressed B+ tree index (see BPlusTreePrefixIndex), populate existing data of the table and
+   * return its metadata. Unlike CreateIndex, the key may have any number of columns of any type.
+   * @param txn The transaction in which the index is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_schema The schema of the key
+   * @param key_attrs Key attributes
+   * @return A (non-owning) pointer to the metadata of the new index
+   */
+  auto CreatePrefixIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
+      -> IndexInfo * {
+    if (table_names_.find(table_name) == table_names_.end()) {
+      return NULL_INDEX_INFO;
+    }
+    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
+    auto &table_indexes = index_names_.find(table_name)->second;
+    if (table_indexes.find(index_name) != table_indexes.end()) {
+      return NULL_INDEX_INFO;
+    }
+
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto index = std::make_unique<BPlusTreePrefixIndex>(std::move(meta), bpm_);
+
     auto *table_meta = GetTable(table_name);
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
       auto [meta, tuple] = iter.GetTuple();
       index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
     }
 
-    // Get the next OID for the new index
-    const auto index_oid = next_index_oid_.fetch_add(1);
+    return RegisterIndex(std::move(index), key_schema, index_name, table_name, key_schema.GetLength());
+  }
 
-    // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    auto *tmp = index_info.get();
+  /**
+   * Create a new non-unique B+ tree index (see BPlusTreePostingIndex), populate existing data of the table and return
+   * its metadata. Like CreateIndex, the key is one or two integer columns; unlike it, tuples may share a key.
+   * @param txn The transaction in which the index is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_schema The schema of the key
+   * @param key_attrs Key attributes
+   * @return A (non-owning) pointer to the metadata of the new index
+   */
+  auto CreatePostingIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
+      -> IndexInfo * {
+    if (table_names_.find(table_name) == table_names_.end()) {
+      return NULL_INDEX_INFO;
+    }
+    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
+    auto &table_indexes = index_names_.find(table_name)->second;
+    if (table_indexes.find(index_name) != table_indexes.end()) {
+      return NULL_INDEX_INFO;
+    }
 
-    // Update internal tracking
-    indexes_.emplace(index_oid, std::move(index_info));
-    table_indexes.emplace(index_name, index_oid);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto index = std::make_unique<BPlusTreePostingIndex>(std::move(meta), bpm_);
 
-    return tmp;
+    auto *table_meta = GetTable(table_name);
+    std::vector<std::pair<IntegerKeyType, RID>> entries;
+    for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+      auto [meta, tuple] = iter.GetTuple();
+      IntegerKeyType index_key;
+      index_key.SetFromKey(tuple.KeyFromTuple(schema, key_schema, key_attrs));
+      entries.emplace_back(index_key, tuple.GetRid());
+    }
+    index->BulkLoad(&entries);
+
+    return RegisterIndex(std::move(index), key_schema, index_name, table_name, TWO_INTEGER_SIZE);
   }
 
   /**
@@ -342,6 +412,24 @@ class Catalog {
   }
 
  private:
+  /** Give a new index an OID and track it under its table. The table must exist and not have an index named so. */
+  auto RegisterIndex(std::unique_ptr<Index> index, const Schema &key_schema, const std::string &index_name,
+                     const std::string &table_name, size_t keysize) -> IndexInfo * {
+    // Get the next OID for the new index
+    const auto index_oid = next_index_oid_.fetch_add(1);
+
+    // Construct index information; IndexInfo takes ownership of the Index itself
+    auto index_info =
+        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto *tmp = index_info.get();
+
+    // Update internal tracking
+    indexes_.emplace(index_oid, std::move(index_info));
+    index_names_.find(table_name)->second.emplace(index_name, index_oid);
+
+    return tmp;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
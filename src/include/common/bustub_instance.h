@@ -210,6 +210,9 @@ class FortTableWriter : public ResultWriter {
   std::vector<std::string> tables_;
 };
 
+/** Number of frames in the buffer pool of a BusTub instance, unless specified otherwise. */
+static constexpr size_t BUSTUB_INSTANCE_BPM_SIZE = 128;
+
 class BustubInstance {
  private:
   /**
@@ -218,9 +221,22 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by a database file.
+   * @param db_file_name the database file, which must have been created with the same page size
+   * @param bpm_size number of frames in the buffer pool
+   * @param page_size size of a page in bytes, a power of two between BUSTUB_PAGE_SIZE and BUSTUB_MAX_PAGE_SIZE
+   * @param async_io whether to do page I/O through DiskManagerAsync instead of DiskManager
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t bpm_size = BUSTUB_INSTANCE_BPM_SIZE,
+                          int page_size = BUSTUB_PAGE_SIZE, bool async_io = false);
 
-  BustubInstance();
+  /**
+   * Create an in-memory BusTub instance.
+   * @param bpm_size number of frames in the buffer pool
+   * @param page_size size of a page in bytes, a power of two between BUSTUB_PAGE_SIZE and BUSTUB_MAX_PAGE_SIZE
+   */
+  explicit BustubInstance(size_t bpm_size = BUSTUB_INSTANCE_BPM_SIZE, int page_size = BUSTUB_PAGE_SIZE);
 
   ~BustubInstance();
 
@@ -279,6 +295,7 @@ class BustubInstance {
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdDisplayStats(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
 
   void HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer);
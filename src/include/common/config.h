@@ -21,21 +21,43 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** The background flusher of the buffer pool wakes up every BACKGROUND_FLUSH_INTERVAL milliseconds. */
+extern std::chrono::milliseconds background_flush_interval;
+
+/** The background compactor of a lazy-deleting B+ tree wakes up every BPLUSTREE_COMPACTION_INTERVAL milliseconds. */
+extern std::chrono::milliseconds bplustree_compaction_interval;
+
+/** The background vacuum of a table heap wakes up every TABLE_HEAP_VACUUM_INTERVAL milliseconds. */
+extern std::chrono::milliseconds table_heap_vacuum_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** Size of a data page in bytes. Chosen once at startup with SetPageSize, before any page is allocated. */
+extern int bustub_page_size;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
-static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
-static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
-static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
-static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int BUSTUB_PAGE_SIZE = 4096;       // default (and smallest) size of a data page in byte
+static constexpr int BUSTUB_MAX_PAGE_SIZE = 32768;  // largest size of a data page in byte
+static constexpr int BUFFER_POOL_SIZE = 10;         // default size of buffer pool
+static constexpr int BUCKET_SIZE = 50;              // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 10;                    // lookback window for lru-k replacer
+static constexpr int LRUK_EVICT_CANDIDATES = 16;              // next victims a filtered eviction tries before giving up
+static constexpr int DISK_IO_QUEUE_DEPTH = 64;                // max in-flight requests of the asynchronous disk manager
+static constexpr double BACKGROUND_FLUSH_CLEAN_RATIO = 0.25;  // share of evictable frames the flusher keeps clean
+static constexpr int SCAN_RING_SIZE = 32;                     // frames a sequential scan may occupy in the pool
+static constexpr int SCAN_READAHEAD_DEPTH = 8;                // pages a sequential scan prefetches ahead of itself
+static constexpr int INDEX_SCAN_BATCH_SIZE = 16;              // tuples an index scan fetches from the heap at once
+static constexpr int INDEX_JOIN_BATCH_SIZE = 64;              // outer tuples an index join probes the index with at once
+static constexpr double BPLUSTREE_FILL_FACTOR = 0.9;          // share of each b+ tree page a bulk load fills
+static constexpr int TABLE_HEAP_INSERT_TARGETS = 8;           // pages of a table heap open to inserts at once
+static constexpr int TABLE_HEAP_VACUUM_BATCH_PAGES = 64;      // pages a background table heap vacuum visits per wake up
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -46,4 +68,16 @@ using oid_t = uint16_t;
 
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
+/**
+ * @brief Set the size of a data page, which must be a power of two between BUSTUB_PAGE_SIZE and BUSTUB_MAX_PAGE_SIZE.
+ *
+ * Everything that lays out a page (Page, TablePage, the B+ tree pages, the disk managers) reads bustub_page_size at
+ * runtime, so this must be called before the first page is allocated, and a database file must always be opened with
+ * the page size it was created with.
+ */
+void SetPageSize(int page_size);
+
+/** @return size of a log buffer in byte */
+inline auto LogBufferSize() -> int { return (BUFFER_POOL_SIZE + 1) * bustub_page_size; }
+
 }  // namespace bustub
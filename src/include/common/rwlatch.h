@@ -29,6 +29,12 @@ class ReaderWriterLatch {
    */
   void WLock() { mutex_.lock(); }
 
+  /**
+   * Try to acquire a write latch without blocking.
+   * @return true if the latch was acquired
+   */
+  auto TryWLock() -> bool { return mutex_.try_lock(); }
+
   /**
    * Release a write latch.
    */
@@ -39,6 +45,12 @@ class ReaderWriterLatch {
    */
   void RLock() { mutex_.lock_shared(); }
 
+  /**
+   * Try to acquire a read latch without blocking.
+   * @return true if the latch was acquired
+   */
+  auto TryRLock() -> bool { return mutex_.try_lock_shared(); }
+
   /**
    * Release a read latch.
    */
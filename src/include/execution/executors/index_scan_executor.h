@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
@@ -42,6 +45,9 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Read the next rid from whichever index the scan is over. */
+  auto NextRid(RID *rid) -> bool;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   /** Metadata identifying the table that should be deleted */
@@ -50,6 +56,19 @@ class IndexScanExecutor : public AbstractExecutor {
   IndexInfo *index_;
 
   IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType> iterator_;
+  /** Set when the index is a BPlusTreePostingIndex, which is then scanned with posting_iterator_ instead. */
+  BPlusTreePostingIndex *posting_index_{nullptr};
+  BPlusTreePostingIndex::PostingIterator posting_iterator_;
+  /** The RIDs of the key posting_iterator_ last stepped over, and the next one to hand out. */
+  std::vector<RID> posting_rids_;
+  size_t posting_pos_{0};
+  /** Set instead of iterator_ when the index is a BPlusTreePrefixIndex. */
+  std::optional<PrefixIndexIterator> prefix_iterator_;
+  /** The encoded upper bound of a scan over a BPlusTreePrefixIndex, past which the scan ends. */
+  std::optional<std::string> prefix_upper_key_;
+  /** Tuples of the rids read ahead from the index, whose pages were fetched together, and the next one to emit. */
+  std::vector<std::pair<TupleMeta, Tuple>> batch_;
+  size_t batch_pos_{0};
   // bool is_first_scan_;
 };
 }  // namespace bustub
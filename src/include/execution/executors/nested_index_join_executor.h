@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -29,6 +30,10 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * Outer tuples are read INDEX_JOIN_BATCH_SIZE at a time, and the index is probed with the keys of a whole batch at
+ * once (see Index::ScanKeys), so that neighbouring keys share the walk down the index. The inner tuples the probes
+ * find are then read together as well.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -48,7 +53,19 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Join the next batch of outer tuples into results_. @return false if the outer side is exhausted */
+  auto JoinBatch() -> bool;
+
+  /** Append the join of outer_tuple and inner_tuple, or of outer_tuple and nulls if inner_tuple is nullptr. */
+  void PutResult(const Tuple &outer_tuple, const Tuple *inner_tuple);
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  const IndexInfo *index_info_;
+  const TableInfo *table_info_;
+  /** The joined tuples of the current batch, and the next one to emit. */
+  std::vector<Tuple> results_;
+  size_t results_pos_{0};
 };
 }  // namespace bustub
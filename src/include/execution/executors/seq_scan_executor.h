@@ -19,6 +19,7 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_cursor.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -52,8 +53,7 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
-  // TableIterator *iter_ = nullptr;
-  std::shared_ptr<TableIterator> iter_;
-  // std::optional<TableIterator> iter_;
+  /** Walks the table a page at a time, see TableCursor */
+  std::unique_ptr<TableCursor> cursor_;
 };
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,9 @@ namespace bustub {
 /**
  * UpdateExecutor executes an update on a table.
  * Updated values are always pulled from a child.
+ *
+ * Tuples are updated in place, see TableHeap::UpdateTuple, and keep their RID, so only the indexes whose key columns
+ * the update sets to something else than the column itself are changed.
  */
 class UpdateExecutor : public AbstractExecutor {
   friend class UpdatePlanNode;
@@ -65,6 +69,10 @@ class UpdateExecutor : public AbstractExecutor {
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
   std::vector<IndexInfo *> index_;
+  /** Whether the update may change the key of each index in index_. */
+  std::vector<bool> key_updated_;
+  /** Tuples this update moved to a new RID, which the child may still scan: they were updated already. */
+  std::unordered_set<RID> moved_rids_;
   uint64_t row_count_;
 
   bool has_exec_;
@@ -51,20 +51,32 @@ class AbstractExpression {
   /** Virtual destructor. */
   virtual ~AbstractExpression() = default;
 
+  /** @return The value obtained by evaluating the tuple, read in place, with the given schema */
+  virtual auto Evaluate(const TupleView &tuple, const Schema &schema) const -> Value = 0;
+
   /** @return The value obtained by evaluating the tuple with the given schema */
-  virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
+  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value {
+    return Evaluate(tuple == nullptr ? TupleView{} : TupleView{*tuple}, schema);
+  }
 
   /**
-   * Returns the value obtained by evaluating a JOIN.
+   * Returns the value obtained by evaluating a JOIN, reading both tuples in place.
    * @param left_tuple The left tuple
    * @param left_schema The left tuple's schema
    * @param right_tuple The right tuple
    * @param right_schema The right tuple's schema
    * @return The value obtained by evaluating a JOIN on the left and right
    */
-  virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  virtual auto EvaluateJoin(const TupleView &left_tuple, const Schema &left_schema, const TupleView &right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /** @return The value obtained by evaluating a JOIN on the left and right tuples */
+  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+                    const Schema &right_schema) const -> Value {
+    return EvaluateJoin(left_tuple == nullptr ? TupleView{} : TupleView{*left_tuple}, left_schema,
+                        right_tuple == nullptr ? TupleView{} : TupleView{*right_tuple}, right_schema);
+  }
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
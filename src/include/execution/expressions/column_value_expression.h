@@ -35,14 +35,17 @@ class ColumnValueExpression : public AbstractExpression {
   ColumnValueExpression(uint32_t tuple_idx, uint32_t col_idx, TypeId ret_type)
       : AbstractExpression({}, ret_type), tuple_idx_{tuple_idx}, col_idx_{col_idx} {}
 
-  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
-    return tuple->GetValue(&schema, col_idx_);
+  using AbstractExpression::Evaluate;
+  using AbstractExpression::EvaluateJoin;
+
+  auto Evaluate(const TupleView &tuple, const Schema &schema) const -> Value override {
+    return tuple.GetValue(&schema, col_idx_);
   }
 
-  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto EvaluateJoin(const TupleView &left_tuple, const Schema &left_schema, const TupleView &right_tuple,
                     const Schema &right_schema) const -> Value override {
-    return tuple_idx_ == 0 ? left_tuple->GetValue(&left_schema, col_idx_)
-                           : right_tuple->GetValue(&right_schema, col_idx_);
+    return tuple_idx_ == 0 ? left_tuple.GetValue(&left_schema, col_idx_)
+                           : right_tuple.GetValue(&right_schema, col_idx_);
   }
 
   auto GetTupleIdx() const -> uint32_t { return tuple_idx_; }
@@ -27,9 +27,12 @@ class ConstantValueExpression : public AbstractExpression {
   /** Creates a new constant value expression wrapping the given value. */
   explicit ConstantValueExpression(const Value &val) : AbstractExpression({}, val.GetTypeId()), val_(val) {}
 
-  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override { return val_; }
+  using AbstractExpression::Evaluate;
+  using AbstractExpression::EvaluateJoin;
 
-  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto Evaluate(const TupleView &tuple, const Schema &schema) const -> Value override { return val_; }
+
+  auto EvaluateJoin(const TupleView &left_tuple, const Schema &left_schema, const TupleView &right_tuple,
                     const Schema &right_schema) const -> Value override {
     return val_;
   }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -22,16 +23,37 @@
 namespace bustub {
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ *
+ * The scan covers the keys between lower_bound_ and upper_bound_ of a single-column index, each of which may be
+ * missing to leave that side of the range open, in ascending key order, or descending if reverse_ is set.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to be scanned
+   * @param reverse whether to scan in descending key order
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, bool reverse = false)
+      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid), reverse_(reverse) {}
+
+  /**
+   * Creates a new index scan plan node over a key range.
+   * @param lower_bound the smallest key to scan, or std::nullopt
+   * @param lower_inclusive whether the range includes lower_bound
+   * @param upper_bound the largest key to scan, or std::nullopt
+   * @param upper_inclusive whether the range includes upper_bound
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::optional<Value> lower_bound, bool lower_inclusive,
+                    std::optional<Value> upper_bound, bool upper_inclusive, bool reverse = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        lower_bound_(std::move(lower_bound)),
+        lower_inclusive_(lower_inclusive),
+        upper_bound_(std::move(upper_bound)),
+        upper_inclusive_(upper_inclusive),
+        reverse_(reverse) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +65,26 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The range of keys to scan. */
+  std::optional<Value> lower_bound_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_bound_;
+  bool upper_inclusive_{true};
+
+  /** Whether to scan from the largest key down. */
+  bool reverse_{false};
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    if (!lower_bound_.has_value() && !upper_bound_.has_value() && !reverse_) {
+      return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    }
+    // An unbounded side is always open.
+    return fmt::format("IndexScan {{ index_oid={}, range={}{}, {}{}{} }}", index_oid_,
+                       lower_bound_.has_value() && lower_inclusive_ ? '[' : '(',
+                       lower_bound_.has_value() ? lower_bound_->ToString() : "-inf",
+                       upper_bound_.has_value() ? upper_bound_->ToString() : "+inf",
+                       upper_bound_.has_value() && upper_inclusive_ ? ']' : ')', reverse_ ? ", reverse" : "");
   }
 };
 
@@ -30,8 +30,8 @@ class LogManager {
  public:
   explicit LogManager(DiskManager *disk_manager)
       : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
-    flush_buffer_ = new char[LOG_BUFFER_SIZE];
+    log_buffer_ = new char[LogBufferSize()];
+    flush_buffer_ = new char[LogBufferSize()];
   }
 
   ~LogManager() {
@@ -29,7 +29,7 @@ class LogRecovery {
  public:
   LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
       : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
+    log_buffer_ = new char[LogBufferSize()];
   }
 
   ~LogRecovery() {
@@ -14,9 +14,11 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -28,6 +30,9 @@ namespace bustub {
  */
 class DiskManager {
  public:
+  /** Completion callback of an asynchronous page I/O. The argument is true iff the I/O succeeded. */
+  using Callback = std::function<void(bool)>;
+
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
@@ -42,7 +47,7 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -58,6 +63,34 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Write a page to the database file without waiting for the I/O. The page data must stay valid until the callback
+   * runs. The default implementation performs a blocking write and invokes the callback inline.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   * @param callback invoked once the write completes
+   */
+  virtual void WritePageAsync(page_id_t page_id, const char *page_data, Callback callback);
+
+  /**
+   * Read a page from the database file without waiting for the I/O. The default implementation performs a blocking
+   * read and invokes the callback inline.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, filled when the callback runs
+   * @param callback invoked once the read completes
+   */
+  virtual void ReadPageAsync(page_id_t page_id, char *page_data, Callback callback);
+
+  /**
+   * Read a run of consecutive pages into separate buffers without waiting for the I/O, with as few requests as the disk
+   * manager can. The default implementation reads the whole run after a single seek, under one acquisition of the file
+   * latch, and invokes the callback inline.
+   * @param first_page_id id of the first page of the run
+   * @param[out] page_data one output buffer per page, filled when the callback runs
+   * @param callback invoked once every page of the run has been read
+   */
+  virtual void ReadPagesAsync(page_id_t first_page_id, std::vector<char *> page_data, Callback callback);
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
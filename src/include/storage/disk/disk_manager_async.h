@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_async.h
+//
+// Identification: src/include/storage/disk/disk_manager_async.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerAsync is a DiskManager that keeps many page reads and writes in flight at the same time.
+ *
+ * On Linux it submits requests to an io_uring instance and a dedicated thread reaps the completions and runs the
+ * callbacks. Requests issued concurrently by different threads are batched into a single submission. Where io_uring is
+ * not available (older kernels, seccomp sandboxes, other platforms) it falls back to a pool of threads issuing
+ * pread/pwrite, which still allows queue_depth requests in flight.
+ *
+ * The database file is opened with O_DIRECT when direct_io is set and the file system supports it. Buffers that are
+ * not aligned to the page size are transparently copied through an aligned bounce buffer.
+ *
+ * The log file is handled exactly like in DiskManager.
+ */
+class DiskManagerAsync : public DiskManager {
+ public:
+  /**
+   * Creates a new asynchronous disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param queue_depth the maximum number of page requests in flight
+   * @param direct_io whether to bypass the OS page cache with O_DIRECT
+   */
+  explicit DiskManagerAsync(const std::string &db_file, size_t queue_depth = DISK_IO_QUEUE_DEPTH,
+                            bool direct_io = true);
+
+  ~DiskManagerAsync() override;
+
+  /** Wait for all in-flight requests, then close all the file resources. */
+  void ShutDown() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void WritePageAsync(page_id_t page_id, const char *page_data, Callback callback) override;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, Callback callback) override;
+
+  /** Reads the run with a single vectored request (IORING_OP_READV, or preadv in the fallback). */
+  void ReadPagesAsync(page_id_t first_page_id, std::vector<char *> page_data, Callback callback) override;
+
+  /** @return true if requests are served by io_uring, false if the thread pool fallback is used */
+  auto UsesIoUring() const -> bool { return ring_fd_ >= 0; }
+
+  /** @return true if the database file was opened with O_DIRECT */
+  auto UsesDirectIO() const -> bool { return direct_io_; }
+
+ private:
+  /** A page request from submission until its callback has run. */
+  struct Request {
+    bool is_write_;
+    page_id_t page_id_;
+    /** The caller's buffer. */
+    char *data_;
+    /** Aligned copy of data_ used for O_DIRECT, nullptr if data_ is used directly. */
+    char *bounce_{nullptr};
+    Callback callback_;
+    /**
+     * For a vectored read of consecutive pages starting at page_id_, one buffer per page, and data_ is unused. With a
+     * bounce buffer the run is read into it contiguously and then copied out.
+     */
+    std::vector<iovec> iov_{};
+    /** Bytes of a write transferred so far. A short write is submitted again for the rest. */
+    size_t written_{0};
+
+    auto NumPages() const -> size_t { return iov_.empty() ? 1 : iov_.size(); }
+  };
+
+  /** Take a slot of the queue depth, blocking while queue_depth_ requests are in flight. */
+  void AcquireSlot();
+  void ReleaseSlot(bool was_write);
+  void Submit(Request *request);
+  /** Hand a request that holds a slot to the ring, or to the thread pool. */
+  void Dispatch(Request *request);
+  /**
+   * Finish a request given the number of bytes transferred (or a negative errno), then run its callback. A write that
+   * transferred only part of the page is submitted again for the rest instead.
+   */
+  void Complete(Request *request, int64_t result);
+
+  auto SetUpRing() -> bool;
+  /** Queue request on the ring. A nullptr request queues a no-op that tells the reaper thread to exit. */
+  void SubmitToRing(Request *request);
+  void ReapCompletions();
+  void RunWorker();
+
+  const size_t queue_depth_;
+  int db_fd_{-1};
+  bool direct_io_;
+  std::atomic<bool> shut_down_{false};
+
+  /** Number of requests in flight, bounded by queue_depth_. */
+  size_t inflight_{0};
+  std::mutex inflight_latch_;
+  std::condition_variable inflight_cv_;
+
+  /* io_uring state, see io_uring_setup(2). ring_fd_ is -1 when the fallback is in use. */
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+  /** Protects the submission queue tail and the members below. */
+  std::mutex sq_latch_;
+  /** Entries written to the submission queue but not yet handed to the kernel. */
+  unsigned sq_pending_{0};
+  /** True while some thread is inside io_uring_enter submitting sq_pending_ on behalf of everyone. */
+  bool sq_submitting_{false};
+  std::thread reaper_;
+
+  /* Thread pool fallback. */
+  std::deque<Request *> queue_;
+  std::mutex queue_latch_;
+  std::condition_variable queue_cv_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
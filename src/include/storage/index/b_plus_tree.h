@@ -12,15 +12,19 @@
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>  // NOLINT
 #include <cstdint>
 #include <deque>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
@@ -74,6 +78,8 @@ class BPlusTree {
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
                      int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  ~BPlusTree();
+
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
@@ -109,6 +115,56 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
+  /**
+   * @brief Replace the value of key in place, with only its leaf write latched.
+   * @return false if key is not in the tree
+   */
+  auto Update(const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * @brief Build the tree bottom-up from a set of entries, packing leaves and internal pages left to right.
+   *
+   * Much cheaper than inserting the entries one by one: every page is written once, and pages are filled to
+   * fill_factor instead of being left half full by splits. The tree must be empty.
+   *
+   * @param entries the key-value pairs in any order. They are sorted in place; of equal keys only the first is kept.
+   * @param fill_factor share of each page's capacity to fill, in (0, 1]
+   * @return false if the tree is not empty
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor = BPLUSTREE_FILL_FACTOR)
+      -> bool;
+
+  /**
+   * @brief Switch Remove between eager and lazy rebalancing.
+   *
+   * Eagerly, a page that drops below half full is refilled from or merged into a sibling right away. Lazily, it is
+   * left alone until it drops below min_size entries, and with min_size 0 it is only ever unlinked once empty. Far
+   * fewer removes then take the pessimistic path, and pages under insert/delete churn are no longer merged and split
+   * over and over; Compact() gives back the space left in underfull pages.
+   *
+   * @param lazy whether to rebalance lazily
+   * @param min_size the size below which a page is still rebalanced in lazy mode
+   */
+  void SetLazyDelete(bool lazy, int min_size = 0);
+
+  /**
+   * @brief Merge or refill every page that is below half full, and drop root pages with a single child.
+   *
+   * Runs with the header page write latched, so it waits for the writers in the tree and holds off new ones.
+   *
+   * @return the number of pages freed
+   */
+  auto Compact() -> int;
+
+  /**
+   * @brief Start a background thread that runs Compact() every bplustree_compaction_interval, if a lazy remove left a
+   * page underfull since the last pass.
+   */
+  void StartBackgroundCompaction();
+
+  /** @brief Stop the background compactor and wait for it to exit. Does nothing if it is not running. */
+  void StopBackgroundCompaction();
+
   // 递归的从pid指向的node中删除key-val，并处理好该页面之下的所有合并操作
   auto RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn, page_id_t &pid, page_id_t &leftestchild,
                               bool &needlookup) -> bool;
@@ -116,6 +172,19 @@ class BPlusTree {
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  /**
+   * @brief Look up many keys in one pass over the tree.
+   *
+   * The keys are visited in sorted order, and each descent starts from the lowest page already on the path that
+   * covers the key, so keys in the same subtree share the upper levels and keys in the same leaf share the leaf.
+   * The children an internal page will be asked for are prefetched as soon as the page is reached.
+   *
+   * @param keys the keys to look up, in any order
+   * @param results resized to keys.size(); the values of keys[i] are appended to (*results)[i]
+   */
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *txn = nullptr);
+
   // Return the page id of the root node
   auto GetRootPageId() const -> page_id_t;
 
@@ -126,6 +195,17 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  /**
+   * @brief Iterate over the keys between lower and upper, stopping at the first key past the range.
+   *
+   * @param lower the low end of the range, or std::nullopt to start from the smallest key
+   * @param upper the high end of the range, or std::nullopt to run to the largest key
+   * @param reverse whether to start from the high end and step back through the range with operator--
+   * @return an iterator at the first key of the range in the direction of the scan, which IsEnd if the range is empty
+   */
+  auto Range(std::optional<IndexKeyBound<KeyType>> lower, std::optional<IndexKeyBound<KeyType>> upper,
+             bool reverse = false) -> INDEXITERATOR_TYPE;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -168,6 +248,68 @@ class BPlusTree {
    */
   auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+  /**
+   * @brief Find the leaf key belongs in by read latch crabbing, and write latch only that leaf.
+   *
+   * The parent of the leaf stays read latched while the leaf's read latch is traded for a write latch, so no split or
+   * merge can reach the leaf in between.
+   *
+   * @return the write latched leaf, or std::nullopt if the tree is empty or key is larger than every key in the tree
+   * (the separators on the path would have to grow, which only the pessimistic path does)
+   */
+  auto FindLeafOptimistic(const KeyType &key) -> std::optional<WritePageGuard>;
+
+  /**
+   * @brief Try to insert with only the leaf write latched.
+   * @return the result of the insert, or std::nullopt if the insert needs the pessimistic path
+   */
+  auto InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool>;
+
+  /** Point the prev link of leaf page_id, unless it is INVALID_PAGE_ID, at prev_page_id. */
+  void SetLeafPrevPageId(page_id_t page_id, page_id_t prev_page_id);
+
+  /**
+   * @brief Try to remove with only the leaf write latched.
+   * @return true if the remove is done, false if it needs the pessimistic path
+   */
+  auto RemoveOptimistic(const KeyType &key) -> bool;
+
+  /**
+   * @brief Read latch the root page, going around the header page unless a writer may be changing the root.
+   * @param[out] header_guard if not null and the header had to be read, the header is left read latched in here
+   * @return the root page, or an invalid guard if the tree is empty
+   */
+  auto FetchRootRead(ReadPageGuard *header_guard = nullptr) -> ReadPageGuard;
+
+  /** With the header write latched: the root page may be replaced or freed from now on. */
+  void BeginRootChange();
+
+  /** With the header still write latched: cache root_page_id as the root for FetchRootRead. */
+  void EndRootChange(page_id_t root_page_id);
+
+  /** Brackets a write that holds the header write latched, from BeginRootChange to EndRootChange. */
+  class RootChange {
+   public:
+    RootChange(BPlusTree *tree, const BPlusTreeHeaderPage *header_page) : tree_(tree), header_page_(header_page) {
+      tree_->BeginRootChange();
+    }
+    RootChange(const RootChange &) = delete;
+    auto operator=(const RootChange &) -> RootChange & = delete;
+    ~RootChange() { tree_->EndRootChange(header_page_->root_page_id_); }
+
+   private:
+    BPlusTree *tree_;
+    const BPlusTreeHeaderPage *header_page_;
+  };
+
+  /** The size below which Remove rebalances page; lower than its min size in lazy mode. */
+  auto RemoveMinSize(const BPlusTreePage *page) const -> int;
+
+  /** Compact the subtree under the write latched internal page. @return the number of pages freed */
+  auto CompactNode(WritePageGuard *guard) -> int;
+
+  void RunBackgroundCompaction();
+
   // member variable
   std::string index_name_;
   BufferPoolManager *bpm_;
@@ -180,6 +322,22 @@ class BPlusTree {
 
   page_id_t del_func_use_ = INVALID_PAGE_ID;
 
+  // The root as of the last write that held the header, so that readers don't have to go through the header page.
+  // root_epoch_ is odd while such a write is under way, and moves on with every one; root_frame_ is where the root
+  // page was last seen in the buffer pool, and may be stale.
+  std::atomic<uint64_t> root_epoch_{0};
+  std::atomic<page_id_t> cached_root_page_id_{INVALID_PAGE_ID};
+  std::atomic<Page *> root_frame_{nullptr};
+
+  std::atomic<bool> lazy_delete_{false};
+  std::atomic<int> lazy_delete_min_size_{0};
+  // Set when a lazy remove leaves a page below its min size, cleared by Compact.
+  std::atomic<bool> compaction_pending_{false};
+  std::atomic<bool> enable_background_compaction_{false};
+  std::thread *background_compaction_thread_{nullptr};
+  std::mutex background_compaction_latch_;
+  std::condition_variable background_compaction_cv_;
+
   // page_id_t end_ = INVALID_PAGE_ID;
 
   // std::unordered_map<page_id_t, page_id_t> left_node_;
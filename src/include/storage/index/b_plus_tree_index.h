@@ -13,7 +13,9 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -35,12 +37,33 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  /**
+   * Build the index bottom-up from a set of entries. The index must be empty.
+   * @param entries The keys and their RIDs in any order, sorted in place
+   * @returns whether the load happened, i.e. the index was empty
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries) -> bool;
+
+  /**
+   * Switch the index to lazy deletion, and run a background compactor while it is on. See BPlusTree::SetLazyDelete.
+   * @param lazy whether removes leave underfull pages for the compactor
+   * @param min_size the size below which a page is still rebalanced right away
+   */
+  void SetLazyDelete(bool lazy, int min_size = 0);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /** Iterate over the keys between lower and upper, backward if reverse. See BPlusTree::Range. */
+  auto GetRangeIterator(std::optional<IndexKeyBound<KeyType>> lower, std::optional<IndexKeyBound<KeyType>> upper,
+                        bool reverse = false) -> INDEXITERATOR_TYPE;
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -53,7 +76,7 @@ class BPlusTreeIndex : public Index {
 constexpr static const auto TWO_INTEGER_SIZE = 8;
 using IntegerKeyType = GenericKey<TWO_INTEGER_SIZE>;
 using IntegerValueType = RID;
-using IntegerComparatorType = GenericComparator<TWO_INTEGER_SIZE>;
+using IntegerComparatorType = GenericIntegerComparator<TWO_INTEGER_SIZE>;
 using BPlusTreeIndexForTwoIntegerColumn = BPlusTreeIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using BPlusTreeIndexIteratorForTwoIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
 
 #include "storage/table/tuple.h"
 #include "type/value.h"
@@ -103,4 +105,97 @@ class GenericComparator {
   Schema *key_schema_;
 };
 
+/**
+ * Comparator for keys made of one or two integer columns, the only keys BusTub builds SQL indexes on.
+ *
+ * Keys are compared on their raw bytes instead of through Value. A single integer column at offset 0 is read as a
+ * little-endian int64 shifted left by RawShift() bits, which sign-extends a narrower integer in place and drops the
+ * zero padding after it; BPlusTree uses this to search nodes with SIMD. Two INTEGER columns are packed into one
+ * order-preserving int64. Any other key schema falls back to comparing Values column by column, like
+ * GenericComparator.
+ */
+template <size_t KeySize>
+class GenericIntegerComparator {
+ public:
+  inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    if (layout_ == Layout::GENERIC) {
+      return GenericComparator<KeySize>(key_schema_)(lhs, rhs);
+    }
+    int64_t lhs_raw = RawKey(lhs);
+    int64_t rhs_raw = RawKey(rhs);
+    if (lhs_raw < rhs_raw) {
+      return -1;
+    }
+    return lhs_raw > rhs_raw ? 1 : 0;
+  }
+
+  /** @return the left shift that makes the first 8 bytes of a key an order-preserving int64, or -1 if there is none */
+  inline auto RawShift() const -> int { return layout_ == Layout::SINGLE ? shift_ : -1; }
+
+  /** @return the key as an order-preserving int64. Only valid if the key schema is not a generic one. */
+  inline auto RawKey(const GenericKey<KeySize> &key) const -> int64_t {
+    if (layout_ == Layout::SINGLE) {
+      uint64_t word;
+      memcpy(&word, key.data_, sizeof(word));
+      return static_cast<int64_t>(word << shift_);
+    }
+    int32_t high;
+    uint32_t low;
+    memcpy(&high, key.data_, sizeof(high));
+    memcpy(&low, key.data_ + sizeof(high), sizeof(low));
+    // the high column keeps its sign in the top bits; the low one is biased so it orders as unsigned below it
+    return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(high)) << 32) | (low ^ 0x80000000U));
+  }
+
+  GenericIntegerComparator(const GenericIntegerComparator &other) = default;
+
+  // constructor
+  explicit GenericIntegerComparator(Schema *key_schema) : key_schema_(key_schema) {
+    if (KeySize < sizeof(int64_t)) {
+      return;
+    }
+    uint32_t column_count = key_schema_->GetColumnCount();
+    if (column_count == 1 && key_schema_->GetColumn(0).GetOffset() == 0) {
+      int width = IntegerWidth(key_schema_->GetColumn(0).GetType());
+      if (width != 0) {
+        layout_ = Layout::SINGLE;
+        shift_ = 64 - 8 * width;
+      }
+    } else if (column_count == 2 && key_schema_->GetColumn(0).GetType() == TypeId::INTEGER &&
+               key_schema_->GetColumn(1).GetType() == TypeId::INTEGER && key_schema_->GetColumn(0).GetOffset() == 0 &&
+               key_schema_->GetColumn(1).GetOffset() == sizeof(int32_t)) {
+      layout_ = Layout::PAIR;
+    }
+  }
+
+ private:
+  enum class Layout { GENERIC, SINGLE, PAIR };
+
+  static auto IntegerWidth(TypeId type) -> int {
+    switch (type) {
+      case TypeId::TINYINT:
+        return 1;
+      case TypeId::SMALLINT:
+        return 2;
+      case TypeId::INTEGER:
+        return 4;
+      case TypeId::BIGINT:
+        return 8;
+      default:
+        return 0;
+    }
+  }
+
+  Schema *key_schema_;
+  Layout layout_{Layout::GENERIC};
+  int shift_{0};
+};
+
+/** Whether a key comparator can expose raw integer keys, which selects the SIMD node search in BPlusTree. */
+template <typename KeyComparator>
+struct IsIntegerKeyComparator : std::false_type {};
+
+template <size_t KeySize>
+struct IsIntegerKeyComparator<GenericIntegerComparator<KeySize>> : std::true_type {};
+
 }  // namespace bustub
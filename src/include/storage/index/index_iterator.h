@@ -13,6 +13,10 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <optional>
+#include <vector>
+
+#include "buffer/scan_prefetcher.h"
 #include "common/config.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/page_guard.h"
@@ -21,20 +25,53 @@ namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/** One end of a key range: the key, and whether the range includes the key itself. */
+template <typename KeyType>
+struct IndexKeyBound {
+  KeyType key_;
+  bool inclusive_{true};
+};
+
+/**
+ * IndexIterator walks the leaf chain of a B+ tree, forward with ++ or backward with --. Leaves are fetched as
+ * AccessType::Scan, and the next SCAN_READAHEAD_DEPTH leaves in the direction of travel are prefetched ahead of the
+ * iterator once it starts moving.
+ *
+ * The iterator never holds a latch between calls: it copies the entries of a leaf out under a short read latch and
+ * serves them from the copy, so a long scan does not stall writers on the leaves it has passed. Moving on to the
+ * neighbouring leaf checks that the two leaves still link to each other and that the copied leaf still ends (or, going
+ * backward, starts) with the same key. A split, merge or redistribution in between fails the check, and the iterator
+ * then finds its place again by descending the tree from the last key it returned.
+ *
+ * A bounded iterator (see BPlusTree::Range) reaches its end as soon as it steps onto a key outside its range, so a
+ * range scan stops at the first leaf past the range instead of reading the rest of the tree.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator(page_id_t pid, BufferPoolManager *bpm_, int ind);
+  /**
+   * Start at entry ind of the leaf held by leaf_guard, which is copied and released. An ind past either end of the
+   * leaf starts on the neighbouring leaf instead. A missing bound leaves that side of the range open.
+   */
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, BufferPoolManager *bpm, ReadPageGuard leaf_guard,
+                int ind, const KeyComparator &comparator, std::optional<IndexKeyBound<KeyType>> lower = std::nullopt,
+                std::optional<IndexKeyBound<KeyType>> upper = std::nullopt);
   IndexIterator() : bpm_(nullptr), pid_(INVALID_PAGE_ID) {}
   ~IndexIterator() = default;  // NOLINT
 
+  /** @return whether the iterator ran off either end of the leaf chain, or out of its range */
   auto IsEnd() const -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
+  /** Step back to the previous key. Stepping back from the first key of the tree ends the iterator. */
+  auto operator--() -> IndexIterator &;
+
   auto operator==(const IndexIterator &itr) const -> bool {
     return (this->pid_ == itr.pid_ && this->bpm_ == itr.bpm_ && this->ind_ == itr.ind_);
   }
@@ -42,16 +79,34 @@ class IndexIterator {
   auto operator!=(const IndexIterator &itr) const -> bool { return !this->operator==(itr); }
 
  private:
-  // add your own private member variables here
-  // ReadPageGuard leaf_pg_guard_;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
   inline auto IsEmpty() const -> bool { return bpm_ == nullptr || pid_ == INVALID_PAGE_ID; }
-  inline auto IsEndP(const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *pg_pointer_) const -> bool {
-    return pg_pointer_->GetNextPageId() == INVALID_PAGE_ID && ind_ >= pg_pointer_->GetSize();
-  }
+  /** Replace the copied entries with those of leaf, which is page page_id. */
+  void CopyLeaf(page_id_t page_id, const LeafPage *leaf);
+  /** Move forward over leaves until ind_ points into the copy, or the copy is of the last leaf. */
+  void NextLeaf();
+  /** Move backward over leaves until ind_ points into the copy, or the iterator ran off the first leaf. */
+  void PrevLeaf();
+  /** Take over the position of an iterator that found its place again by descending the tree. */
+  void Resume(IndexIterator &&resumed);
+  /** @return whether key lies between lower_ and upper_ */
+  auto InRange(const KeyType &key) const -> bool;
+
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
   BufferPoolManager *bpm_;
   page_id_t pid_;
-  // const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *pg_pointer_;
-  int ind_;
+  int ind_{0};
+  /** The entries of leaf pid_ as of the last time it was read, and its neighbours at that time. */
+  std::vector<MappingType> entries_;
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  page_id_t prev_page_id_{INVALID_PAGE_ID};
+  ScanPrefetcher prefetcher_;
+  /** Follows the prev links for backward scans. */
+  ScanPrefetcher prev_prefetcher_;
+  std::optional<KeyComparator> comparator_;
+  std::optional<IndexKeyBound<KeyType>> lower_;
+  std::optional<IndexKeyBound<KeyType>> upper_;
 };
 
 }  // namespace bustub
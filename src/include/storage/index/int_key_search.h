@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// int_key_search.h
+//
+// Identification: src/include/storage/index/int_key_search.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * @brief Lower bound over the sorted integer keys of a B+ tree node.
+ *
+ * Key i is the little-endian int64 word at base + i * stride, shifted left by shift bits (see
+ * GenericIntegerComparator::RawShift). Binary search narrows the range down to a few cachelines, which are then
+ * scanned linearly with AVX2 or SSE4.2 when the CPU has them.
+ *
+ * @param base address of the first key
+ * @param stride distance between two keys in bytes
+ * @param n number of keys
+ * @param key the key to look for, already shifted
+ * @param shift left shift applied to every key word
+ * @return index of the first key not less than key, or n if there is none
+ */
+auto IntKeyLowerBound(const char *base, size_t stride, int n, int64_t key, int shift) -> int;
+
+}  // namespace bustub
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/posting_b_plus_tree_index.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/index.h"
+#include "storage/page/posting_list_page.h"
+
+namespace bustub {
+
+/**
+ * Non-unique B+ tree index over one or two integer columns, for columns such as foreign keys where many tuples share
+ * a key. Created with CREATE INDEX ... USING posting_btree; BPlusTreeIndexForTwoIntegerColumn only takes one tuple
+ * per key.
+ *
+ * Every key appears once in the tree, with a PostingList of the RIDs of all its tuples as the value. Short lists live
+ * inline in the leaf; longer ones spill to a chain of PostingListPages.
+ *
+ * The tree latches its own pages, but a change to a posting list is a read, modify and write of the leaf value and
+ * possibly its overflow pages. Those run under a latch striped by key, exclusive for writers and shared for readers
+ * of the overflow pages.
+ */
+class BPlusTreePostingIndex : public Index {
+ public:
+  /** The access method name that selects this index in CREATE INDEX ... USING. */
+  static constexpr const char *ACCESS_METHOD = "posting_btree";
+
+  using PostingTree = BPlusTree<IntegerKeyType, PostingList, IntegerComparatorType>;
+  using PostingIterator = IndexIterator<IntegerKeyType, PostingList, IntegerComparatorType>;
+
+  BPlusTreePostingIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  /** Add rid to the posting list of key. @return false if it is there already */
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  /** Remove rid from the posting list of key, and key from the tree once its list is empty. */
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  /** Append every RID of key to result, in RID order. */
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  /**
+   * Build the index bottom-up from a set of entries, which may share keys. The index must be empty.
+   * @param entries The keys and their RIDs in any order, sorted in place
+   * @returns whether the load happened, i.e. the index was empty
+   */
+  auto BulkLoad(std::vector<std::pair<IntegerKeyType, RID>> *entries) -> bool;
+
+  /** Iterate over the keys between lower and upper and their posting lists; see BPlusTree::Range and GetRids. */
+  auto GetRangeIterator(std::optional<IndexKeyBound<IntegerKeyType>> lower,
+                        std::optional<IndexKeyBound<IntegerKeyType>> upper, bool reverse = false) -> PostingIterator;
+
+  /**
+   * @brief Append the RIDs of list, which an iterator or lookup of the tree read for key, to rids.
+   *
+   * An inline list is decoded from the copy. The overflow pages of a list may have changed since the copy was made, so
+   * a list in overflow pages is looked up again under the key's latch.
+   */
+  void GetRids(const IntegerKeyType &key, const PostingList &list, std::vector<RID> *rids);
+
+  auto GetTree() -> PostingTree * { return container_.get(); }
+
+ private:
+  static constexpr size_t KEY_LATCH_COUNT = 64;
+
+  auto KeyLatch(const IntegerKeyType &key) -> std::shared_mutex &;
+
+  /** Write rids, which must be sorted, to a new chain of overflow pages. @return the first page of the chain */
+  auto WriteOverflowPages(const std::vector<RID> &rids) -> page_id_t;
+
+  /** Append the RIDs of the chain of overflow pages starting at page_id to rids. */
+  void ReadOverflowPages(page_id_t page_id, std::vector<RID> *rids);
+
+  /** Add rid to a list in overflow pages, splitting the page it goes to if that is full. @return false if present */
+  auto InsertOverflow(PostingList *list, RID rid) -> bool;
+
+  /**
+   * Remove rid from a list in overflow pages, freeing the page it was on if that empties, and moving the list back
+   * inline once it fits there. @return false if rid is not in the list
+   */
+  auto RemoveOverflow(PostingList *list, RID rid) -> bool;
+
+  IntegerComparatorType comparator_;
+  BufferPoolManager *bpm_;
+  std::unique_ptr<PostingTree> container_;
+  IntegerHashFunctionType hash_function_;
+  std::array<std::shared_mutex, KEY_LATCH_COUNT> key_latches_;
+};
+
+}  // namespace bustub
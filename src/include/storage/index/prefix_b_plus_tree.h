@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefix_b_plus_tree.h
+//
+// Identification: src/include/storage/index/prefix_b_plus_tree.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/b_plus_tree_prefix_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+/**
+ * PrefixIndexIterator walks the leaf chain of a PrefixBPlusTree, skipping empty leaves.
+ */
+class PrefixIndexIterator {
+ public:
+  PrefixIndexIterator() = default;
+  PrefixIndexIterator(BufferPoolManager *bpm, page_id_t pid, int ind);
+
+  auto IsEnd() const -> bool { return pid_ == INVALID_PAGE_ID; }
+
+  /** @return the full key and the RID at the iterator */
+  auto operator*() -> std::pair<std::string, RID>;
+
+  auto operator++() -> PrefixIndexIterator &;
+
+  auto operator==(const PrefixIndexIterator &itr) const -> bool { return pid_ == itr.pid_ && ind_ == itr.ind_; }
+
+  auto operator!=(const PrefixIndexIterator &itr) const -> bool { return !this->operator==(itr); }
+
+ private:
+  /** Move forward to the first leaf, from pid_ on, that has an entry at ind_ or after. */
+  void SkipExhaustedLeaves();
+
+  BufferPoolManager *bpm_{nullptr};
+  page_id_t pid_{INVALID_PAGE_ID};
+  int ind_{0};
+};
+
+/**
+ * A B+ tree over variable-length byte-string keys that sort by memcmp, with unique keys and RID values.
+ *
+ * Leaves store the prefix their keys share only once, and internal pages hold separators truncated to the shortest
+ * prefix that tells two children apart (see BPlusTreePrefixPage). For wide composite keys, which mostly differ in
+ * their last bytes, far more entries fit in a page than in the fixed-size GenericKey pages of BPlusTree, so the tree
+ * is shallower and touches fewer pages per lookup.
+ *
+ * Readers crab read latches from the header page down. Writers hold the header page write latch for the whole
+ * operation, since an insert can change the prefix, and thus the size, of every page on its path. Removes never
+ * merge pages; leaves may be left empty.
+ */
+class PrefixBPlusTree {
+  using LeafPage = BPlusTreePrefixLeafPage;
+  using InternalPage = BPlusTreePrefixInternalPage;
+  using Entry = BPlusTreePrefixPage::Entry;
+
+ public:
+  PrefixBPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager);
+
+  /** @return the longest key the tree accepts, which guarantees any page can be split into two that fit */
+  static auto MaxKeySize() -> size_t;
+
+  // Returns true if this B+ tree has no keys and values.
+  auto IsEmpty() const -> bool;
+
+  /** @return false if key is already in the tree or longer than MaxKeySize */
+  auto Insert(std::string_view key, RID value) -> bool;
+
+  void Remove(std::string_view key);
+
+  // Return the value associated with a given key
+  auto GetValue(std::string_view key, std::vector<RID> *result) -> bool;
+
+  // Return the page id of the root node
+  auto GetRootPageId() const -> page_id_t;
+
+  /** @return the number of levels of the tree, 0 if it is empty */
+  auto GetHeight() -> int;
+
+  // Index iterator
+  auto Begin() -> PrefixIndexIterator;
+
+  auto Begin(std::string_view key) -> PrefixIndexIterator;
+
+  auto End() -> PrefixIndexIterator;
+
+ private:
+  /** Find the leaf key belongs in by crabbing read latches. Returns an invalid guard if the tree is empty. */
+  auto FindLeafRead(std::string_view key, bool leftmost) -> ReadPageGuard;
+
+  /**
+   * @brief Find where to split entries so that both halves fit in a page, as evenly as possible.
+   * @param skip_first whether the entries belong to an internal page
+   * @return the index of the first entry of the right half
+   */
+  static auto SplitPoint(const std::vector<Entry> &entries, bool skip_first) -> size_t;
+
+  /** @return the shortest key greater than lo and not greater than hi */
+  static auto ShortestSeparator(const std::string &lo, const std::string &hi) -> std::string;
+
+  /**
+   * @brief Insert separator and right_page_id, the new right sibling of the last page of path, into its parent,
+   * splitting parents as needed. path holds the write latched pages from the root down.
+   */
+  void InsertIntoParent(std::vector<WritePageGuard> *path, BPlusTreeHeaderPage *header, std::string separator,
+                        page_id_t right_page_id);
+
+  std::string index_name_;
+  BufferPoolManager *bpm_;
+  page_id_t header_page_id_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefix_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/prefix_b_plus_tree_index.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/prefix_b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * B+ tree index with prefix-compressed leaves and suffix-truncated separators, over keys of any number and type of
+ * columns. Created with CREATE INDEX ... USING prefix_btree; BPlusTreeIndexForTwoIntegerColumn is the default.
+ *
+ * Keys are stored in an order-preserving byte encoding (see EncodeKey), so the tree compares them with memcmp and
+ * never needs the key schema.
+ */
+class BPlusTreePrefixIndex : public Index {
+ public:
+  /** The access method name that selects this index in CREATE INDEX ... USING. */
+  static constexpr const char *ACCESS_METHOD = "prefix_btree";
+
+  BPlusTreePrefixIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  auto GetBeginIterator() -> PrefixIndexIterator;
+
+  auto GetBeginIterator(const Tuple &key) -> PrefixIndexIterator;
+
+  auto GetEndIterator() -> PrefixIndexIterator;
+
+  /**
+   * @brief Encode a key tuple into bytes that sort like the key, column by column.
+   *
+   * Every column starts with a byte telling NULL (0) from not NULL (1), so NULLs sort first. Integers are stored big
+   * endian with the sign bit flipped, decimals by their IEEE bits flipped to sort as unsigned, and strings escape
+   * 0x00 as 0x00 0xff and end with 0x00 0x00 so a shorter string sorts before its extensions.
+   */
+  static auto EncodeKey(const Tuple &key, const Schema &key_schema) -> std::string;
+
+  auto GetTree() -> PrefixBPlusTree * { return container_.get(); }
+
+ private:
+  std::unique_ptr<PrefixBPlusTree> container_;
+};
+
+}  // namespace bustub
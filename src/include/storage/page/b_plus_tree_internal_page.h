@@ -19,7 +19,7 @@ namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_SIZE ((bustub_page_size - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -48,6 +48,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void Init(int max_size = INTERNAL_PAGE_SIZE);
 
   auto ArrayAt(int index) -> MappingType &;
+  auto ArrayAt(int index) const -> const MappingType &;
   void SetValueAt(int index, const ValueType &val);
 
   /**
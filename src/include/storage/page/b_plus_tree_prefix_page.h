@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_prefix_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_prefix_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * Page of a PrefixBPlusTree, holding variable-length byte-string keys that sort by memcmp.
+ *
+ * Keys share a common prefix, which is stored once at the end of the page; each entry only stores its suffix. A slot
+ * array grows forward from the header, suffixes grow backward towards it from the prefix:
+ *
+ *  -----------------------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n-1) | free | SUFFIX(n-1) ... SUFFIX(0) | PREFIX |
+ *  -----------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 20 bytes in total):
+ *  -----------------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | PrefixLength (2) | HeapBegin (2) |
+ *  -----------------------------------------------------------------------------------
+ *
+ *  Slot format (size in byte, 12 bytes in total):
+ *  ---------------------------------------------------
+ * | SuffixOffset (2) | SuffixLength (2) | Payload (8) |
+ *  ---------------------------------------------------
+ *
+ * MaxSize is unused: a page is full when its bytes are. Pages are rewritten as a whole with Build on every change,
+ * which keeps them compact and lets the prefix grow and shrink with their contents.
+ */
+class BPlusTreePrefixPage : public BPlusTreePage {
+ public:
+  BPlusTreePrefixPage() = delete;
+  BPlusTreePrefixPage(const BPlusTreePrefixPage &other) = delete;
+
+  /** An entry with its full key, and its payload (a RID in leaves, a child page id in internal pages). */
+  using Entry = std::pair<std::string, uint64_t>;
+
+  static constexpr size_t HEADER_SIZE = 20;
+  static constexpr size_t SLOT_SIZE = 12;
+
+  /** @return the number of bytes a page needs to hold entries; the key of the first entry is ignored if skip_first */
+  static auto RequiredSize(const std::vector<Entry> &entries, bool skip_first) -> size_t;
+
+  /** @return the length of the longest prefix shared by the keys of entries, skipping the first one if skip_first */
+  static auto CommonPrefixLength(const std::vector<Entry> &entries, bool skip_first) -> size_t;
+
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the prefix shared by the keys of this page */
+  auto Prefix() const -> std::string_view;
+
+  /** @return the full key at index */
+  auto KeyAt(int index) const -> std::string;
+
+  /** @return the payload at index */
+  auto PayloadAt(int index) const -> uint64_t;
+
+  /** @return the bytes this page has left */
+  auto FreeSpace() const -> size_t;
+
+  /** @return all entries of this page, with full keys */
+  auto Entries() const -> std::vector<Entry>;
+
+ protected:
+  /**
+   * @brief Rewrite the page to hold exactly entries, which must be sorted and fit (see RequiredSize).
+   * @param skip_first whether the key of the first entry is unused, as in internal pages
+   */
+  void Build(const std::vector<Entry> &entries, bool skip_first);
+
+  /**
+   * @brief Compare a key that starts with the page prefix with the key at index.
+   * @param key_rest the part of the key after the prefix
+   */
+  auto CompareSuffix(std::string_view key_rest, int index) const -> int;
+
+  /**
+   * @brief Compare key with the page prefix.
+   * @return < 0 if key sorts before every key of the page that has the prefix, > 0 if after, 0 if key starts with it
+   */
+  auto ComparePrefix(std::string_view key) const -> int;
+
+  /** @return index of the first key in [begin, GetSize()) not less than key, or GetSize() if there is none */
+  auto LowerBound(std::string_view key, int begin) const -> int { return Search(key, begin, false); }
+
+  /** @return index of the first key in [begin, GetSize()) greater than key, or GetSize() if there is none */
+  auto UpperBound(std::string_view key, int begin) const -> int { return Search(key, begin, true); }
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    char payload_[8];
+  };
+
+  auto SlotAt(int index) const -> const Slot *;
+  auto SuffixAt(int index) const -> std::string_view;
+  auto Search(std::string_view key, int begin, bool upper) const -> int;
+
+  page_id_t next_page_id_;
+  uint16_t prefix_length_;
+  uint16_t heap_begin_;
+};
+
+/** Leaf page of a PrefixBPlusTree: sorted keys with their RIDs, chained through the next page id. */
+class BPlusTreePrefixLeafPage : public BPlusTreePrefixPage {
+ public:
+  BPlusTreePrefixLeafPage() = delete;
+  BPlusTreePrefixLeafPage(const BPlusTreePrefixLeafPage &other) = delete;
+
+  /** Must be called after creating a new leaf page from the buffer pool. */
+  void Init();
+
+  /** Rewrite the page to hold exactly entries, which must be sorted and fit. */
+  void Build(const std::vector<Entry> &entries) { BPlusTreePrefixPage::Build(entries, false); }
+
+  /** @return whether entries fit in a leaf page */
+  static auto Fits(const std::vector<Entry> &entries) -> bool {
+    return RequiredSize(entries, false) <= static_cast<size_t>(bustub_page_size);
+  }
+
+  auto ValueAt(int index) const -> RID { return RID(static_cast<int64_t>(PayloadAt(index))); }
+
+  /** @return index of the first key not less than key, or GetSize() if there is none */
+  auto KeyIndex(std::string_view key) const -> int { return LowerBound(key, 0); }
+
+  static auto MakeEntry(std::string key, RID rid) -> Entry {
+    return {std::move(key), static_cast<uint64_t>(rid.Get())};
+  }
+};
+
+/**
+ * Internal page of a PrefixBPlusTree. Entry 0 holds only the leftmost child; entry i > 0 holds a separator key and
+ * the child whose keys are all at least that separator and less than the next one. Separators are truncated to the
+ * shortest prefix that still separates the two children.
+ */
+class BPlusTreePrefixInternalPage : public BPlusTreePrefixPage {
+ public:
+  BPlusTreePrefixInternalPage() = delete;
+  BPlusTreePrefixInternalPage(const BPlusTreePrefixInternalPage &other) = delete;
+
+  /** Must be called after creating a new internal page from the buffer pool. */
+  void Init();
+
+  /** Rewrite the page to hold exactly entries, which must be sorted and fit. The key of entries[0] is ignored. */
+  void Build(const std::vector<Entry> &entries) { BPlusTreePrefixPage::Build(entries, true); }
+
+  /** @return whether entries fit in an internal page */
+  static auto Fits(const std::vector<Entry> &entries) -> bool {
+    return RequiredSize(entries, true) <= static_cast<size_t>(bustub_page_size);
+  }
+
+  auto ValueAt(int index) const -> page_id_t { return static_cast<page_id_t>(PayloadAt(index)); }
+
+  /** @return index of the child whose subtree key belongs in */
+  auto ChildIndex(std::string_view key) const -> int;
+
+  static auto MakeEntry(std::string key, page_id_t child) -> Entry {
+    return {std::move(key), static_cast<uint64_t>(static_cast<uint32_t>(child))};
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Page of the free space map of a table heap. Each entry records a page of the heap that has room for more tuples, how
+ * much room as a category of FreeSpaceMap, and how many tuples the page had when it was recorded. The pages of a map
+ * are chained, and the entries are packed at the front of the chain.
+ *
+ *  Header format (size in byte, 8 bytes in total):
+ *  -------------------------------
+ * | NextPageId (4) | Count (4) |
+ *  -------------------------------
+ *  Entry format (size in byte, 8 bytes each):
+ *  -----------------------------------------------
+ * | PageId (4) | Category (2) | NumTuples (2) |
+ *  -----------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  FreeSpaceMapPage() = delete;
+  FreeSpaceMapPage(const FreeSpaceMapPage &other) = delete;
+
+  static constexpr size_t HEADER_SIZE = 8;
+
+  struct Entry {
+    page_id_t page_id_;
+    uint16_t category_;
+    uint16_t num_tuples_;
+  };
+
+  /** @return the number of entries a page holds */
+  static auto Capacity() -> uint32_t { return (bustub_page_size - HEADER_SIZE) / sizeof(Entry); }
+
+  /** Must be called after creating a new free space map page from the buffer pool. */
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  auto GetCount() const -> uint32_t { return count_; }
+  void SetCount(uint32_t count) { count_ = count; }
+
+  auto EntryAt(uint32_t index) const -> const Entry & { return entries_[index]; }
+  void SetEntryAt(uint32_t index, const Entry &entry) { entries_[index] = entry; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  // Flexible array member for the entries
+  Entry entries_[0];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) == FreeSpaceMapPage::HEADER_SIZE);
+static_assert(sizeof(FreeSpaceMapPage::Entry) == 8);
+
+}  // namespace bustub
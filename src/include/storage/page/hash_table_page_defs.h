@@ -25,6 +25,9 @@
  * key/value pair, we need two additional bits for occupied_ and readable_. 4 * BUSTUB_PAGE_SIZE / (4 * sizeof
  * (MappingType) + 1) = BUSTUB_PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
  * to maintain the occupied and readable flags for a key value pair.
+ *
+ * The hash table pages are laid out at compile time, so they are sized for the smallest page, BUSTUB_PAGE_SIZE, and
+ * leave the rest of a larger page unused.
  */
 #define BLOCK_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
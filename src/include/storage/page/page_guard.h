@@ -64,6 +64,9 @@ class BasicPageGuard {
    */
   ~BasicPageGuard();
 
+  /** @return false if the guard holds no page, because the fetch failed or the guard was dropped */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
   auto PageId() -> page_id_t { return page_->GetPageId(); }
 
   auto GetData() -> const char * { return page_->GetData(); }
@@ -138,6 +141,8 @@ class ReadPageGuard {
    */
   ~ReadPageGuard();
 
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
   auto PageId() -> page_id_t { return guard_.PageId(); }
 
   auto GetData() -> const char * { return guard_.GetData(); }
@@ -198,6 +203,8 @@ class WritePageGuard {
    */
   ~WritePageGuard();
 
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
   auto PageId() -> page_id_t { return guard_.PageId(); }
 
   auto GetData() -> const char * { return guard_.GetData(); }
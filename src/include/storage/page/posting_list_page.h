@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_list_page.h
+//
+// Identification: src/include/storage/page/posting_list_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * The encoding of the RIDs of a posting list: sorted by RID::Get(), each stored as the varint (7 bits a byte, low bits
+ * first, high bit set on all bytes but the last) of its distance from the one before it. The first is stored whole.
+ * RIDs of a table heap are mostly close together, so most take one or two bytes instead of eight.
+ */
+class RidDeltaCodec {
+ public:
+  /** @return the bytes that rids[begin, end), which must be sorted, take encoded */
+  static auto EncodedSize(const std::vector<RID> &rids, size_t begin, size_t end) -> size_t;
+
+  /** @return the largest end such that rids[begin, end), which must be sorted, take at most capacity bytes encoded */
+  static auto FitCount(const std::vector<RID> &rids, size_t begin, size_t capacity) -> size_t;
+
+  /** Encode rids[begin, end), which must be sorted, into out. @return the bytes written */
+  static auto Encode(const std::vector<RID> &rids, size_t begin, size_t end, char *out) -> size_t;
+
+  /** Decode count RIDs from data and append them to rids. */
+  static void Decode(const char *data, uint32_t count, std::vector<RID> *rids);
+};
+
+/**
+ * The value of a key in a BPlusTreePostingIndex: the RIDs of every tuple with that key.
+ *
+ * A short list is stored inline, delta encoded in data_. Once it no longer fits there it is moved to a chain of
+ * PostingListPages, and only the first page id and the total count stay in the tree.
+ *
+ *  Format (size in byte, 32 bytes in total):
+ *  ---------------------------------------------------
+ * | Count (4) | OverflowPageId (4) | InlineRids (24) |
+ *  ---------------------------------------------------
+ */
+class PostingList {
+ public:
+  static constexpr size_t INLINE_SIZE = 24;
+
+  PostingList() = default;
+
+  /** A list of only rid. */
+  explicit PostingList(RID rid);
+
+  /** @return the number of RIDs in the list, inline or not */
+  auto GetCount() const -> uint32_t { return count_; }
+
+  /** @return whether the RIDs are stored inline, rather than in overflow pages */
+  auto IsInline() const -> bool { return overflow_page_id_ == INVALID_PAGE_ID; }
+
+  /** @return the first overflow page of the list, or INVALID_PAGE_ID if it is inline */
+  auto GetOverflowPageId() const -> page_id_t { return overflow_page_id_; }
+
+  /**
+   * @brief Store rids, which must be sorted, inline.
+   * @return false if they don't fit, in which case the list is unchanged
+   */
+  auto SetInline(const std::vector<RID> &rids) -> bool;
+
+  /** Point the list at a chain of overflow pages holding count RIDs. */
+  void SetOverflow(page_id_t overflow_page_id, uint32_t count);
+
+  /** Append the inline RIDs to rids. The list must be inline. */
+  void GetInline(std::vector<RID> *rids) const;
+
+ private:
+  uint32_t count_{0};
+  page_id_t overflow_page_id_{INVALID_PAGE_ID};
+  char data_[INLINE_SIZE]{};
+};
+
+/**
+ * Overflow page of a posting list. The pages of a list are chained in RID order and every RID of a page sorts before
+ * those of the next one. Each page encodes its own RIDs from scratch (see RidDeltaCodec), so it can be read and
+ * rewritten on its own.
+ *
+ *  Header format (size in byte, 24 bytes in total):
+ *  -------------------------------------------------------------------------
+ * | NextPageId (4) | Count (4) | Size (4) | Reserved (4) | LastRid (8) |
+ *  -------------------------------------------------------------------------
+ */
+class PostingListPage {
+ public:
+  PostingListPage() = delete;
+  PostingListPage(const PostingListPage &other) = delete;
+
+  static constexpr size_t HEADER_SIZE = 24;
+
+  /** @return the bytes a page has for encoded RIDs */
+  static auto Capacity() -> size_t { return bustub_page_size - HEADER_SIZE; }
+
+  /** Must be called after creating a new overflow page from the buffer pool. */
+  void Init();
+
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  auto GetCount() const -> uint32_t { return count_; }
+
+  /** @return the bytes the encoded RIDs take */
+  auto GetEncodedSize() const -> uint32_t { return size_; }
+
+  /** @return the largest RID of the page, which must not be empty */
+  auto GetLastRid() const -> RID { return RID(last_rid_); }
+
+  /** Append the RIDs of the page to rids. */
+  void GetRids(std::vector<RID> *rids) const;
+
+  /**
+   * @brief Rewrite the page to hold exactly rids[begin, end), which must be sorted.
+   * @return false if they don't fit, in which case the page is unchanged
+   */
+  auto SetRids(const std::vector<RID> &rids, size_t begin, size_t end) -> bool;
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  uint32_t size_;
+  uint32_t reserved_;
+  int64_t last_rid_;
+  // Flexible array member for the encoded RIDs
+  char data_[0];
+};
+
+}  // namespace bustub
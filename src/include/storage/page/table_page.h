@@ -47,6 +47,10 @@ static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
  *
  * Tuple format:
  * | meta | data |
+ *
+ * The top bit of a tuple's size marks a forwarded slot. A tuple that outgrew its page moved to another one and left
+ * the RID of its new place as the data of its slot. The moved tuple is marked the same way, and is also marked
+ * deleted, so scans only find it through the slot it moved from.
  */
 
 class TablePage {
@@ -59,12 +63,18 @@ class TablePage {
   /** @return number of tuples in this page */
   auto GetNumTuples() const -> uint32_t { return num_tuples_; }
 
+  /** @return number of tuples in this page that are marked deleted */
+  auto GetNumDeletedTuples() const -> uint32_t { return num_deleted_tuples_; }
+
   /** @return the page ID of the next table page */
   auto GetNextPageId() const -> page_id_t { return next_page_id_; }
 
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+  /** @return the length of the largest tuple that still fits in this page */
+  auto GetFreeSpace() const -> size_t;
+
   /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
@@ -90,6 +100,41 @@ class TablePage {
    */
   auto GetTupleMeta(const RID &rid) const -> TupleMeta;
 
+  /**
+   * Read the bytes of a tuple in place.
+   * @return the start of the tuple in the page, and its length
+   */
+  auto GetTupleData(const RID &rid) const -> std::pair<const char *, uint32_t>;
+
+  /**
+   * Reclaim the bytes of the deleted tuples, and pack the rest towards the end of the page. The slots of deleted tuples
+   * stay as tombstones of length zero, so the RIDs of the other tuples don't change.
+   * @return the number of bytes reclaimed
+   */
+  auto Compact() -> size_t;
+
+  /**
+   * Replace the data of a tuple, keeping its meta. A tuple that grows takes the room it needs from the free space of
+   * the page, moving the tuples stored after it.
+   * @return false if the page has no room for the new data
+   */
+  auto UpdateTupleInPlace(const Tuple &tuple, const RID &rid) -> bool;
+
+  /** @return where the tuple moved to, if it is forwarded */
+  auto GetForward(const RID &rid) const -> std::optional<RID>;
+
+  /**
+   * Forward a tuple that moved to another page: its slot keeps only the RID of the new place.
+   * @return false if the page has no room for the RID
+   */
+  auto SetForward(const RID &rid, const RID &forward_rid) -> bool;
+
+  /** Mark a tuple, inserted as deleted, as the new place of a forwarded tuple, so that Compact keeps it. */
+  void SetForwardedCopy(const RID &rid);
+
+  /** Unmark a tuple marked with SetForwardedCopy, that no slot forwards to anymore or that is not deleted anymore. */
+  void ClearForwardedCopy(const RID &rid);
+
   /**
    * Update a tuple in place.
    */
@@ -99,6 +144,14 @@ class TablePage {
 
  private:
   using TupleInfo = std::tuple<uint16_t, uint16_t, TupleMeta>;
+
+  /** The bit of the size of a forwarded slot or of a forwarded tuple. Tuples are smaller than the largest page. */
+  static constexpr uint16_t FORWARD_FLAG = 0x8000;
+  static_assert(BUSTUB_MAX_PAGE_SIZE <= FORWARD_FLAG);
+
+  /** Replace the data of the tuple at tuple_id, see UpdateTupleInPlace. */
+  auto ResizeTuple(uint16_t tuple_id, const char *data, uint16_t new_size) -> bool;
+
   char page_start_[0];
   page_id_t next_page_id_;
   uint16_t num_tuples_;
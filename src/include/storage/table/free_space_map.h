@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks the pages of a table heap that have room for more tuples but that no inserter is filling.
+ *
+ * Pages are bucketed by their free bytes into CATEGORY_COUNT categories: a page in category c has at least c / 64 of a
+ * page free. Pages with less than 1 / 64 of a page free are not worth tracking and are left out. Taking a page for a
+ * tuple picks the fullest page that is certain to fit it, and removes it from the map until it is released again.
+ *
+ * Every change is written through to a chain of FreeSpaceMapPages, from which the map can be loaded again.
+ *
+ * The map is not synchronized: TableHeap only calls it under its latch.
+ */
+class FreeSpaceMap {
+ public:
+  static constexpr uint32_t CATEGORY_COUNT = 64;
+
+  /**
+   * Create a free space map.
+   * @param bpm the buffer pool manager
+   * @param first_page_id the first page of an existing map to load, or INVALID_PAGE_ID for a new, empty map
+   */
+  explicit FreeSpaceMap(BufferPoolManager *bpm, page_id_t first_page_id = INVALID_PAGE_ID);
+
+  /** @return the first page of the map, or INVALID_PAGE_ID if nothing was ever recorded */
+  auto GetFirstPageId() const -> page_id_t { return map_page_ids_.empty() ? INVALID_PAGE_ID : map_page_ids_[0]; }
+
+  /** @return the number of heap pages in the map */
+  auto Size() const -> size_t { return slots_.size(); }
+
+  /**
+   * Record that a heap page has free_bytes of room left, and that no inserter is filling it anymore.
+   * @param page_id the heap page
+   * @param free_bytes the size of the largest tuple that still fits in the page, see TablePage::GetFreeSpace
+   * @param num_tuples the number of tuples the page holds
+   */
+  void Release(page_id_t page_id, size_t free_bytes, uint32_t num_tuples);
+
+  /**
+   * Take a page with room for a tuple out of the map.
+   * @param tuple_size the length of the tuple
+   * @return the page, or INVALID_PAGE_ID if no page in the map is certain to fit the tuple
+   */
+  auto Take(size_t tuple_size) -> page_id_t;
+
+  /**
+   * Take a heap page out of the map, whatever its free space.
+   * @return false if the page is not in the map
+   */
+  auto Remove(page_id_t page_id) -> bool;
+
+  /** Add the number of tuples of every page in the map to tuple_counts. */
+  void GetTupleCounts(std::unordered_map<page_id_t, uint32_t> *tuple_counts) const;
+
+ private:
+  struct PageInfo {
+    uint32_t slot_;
+    uint16_t category_;
+    uint16_t num_tuples_;
+  };
+
+  /** @return the category of a page with free_bytes free */
+  static auto CategoryOf(size_t free_bytes) -> uint32_t;
+
+  /** Write the entry of the heap page at slot to the map page that holds the slot, adding that page if needed. */
+  void WriteSlot(uint32_t slot);
+
+  /** Write the entry count of the map page that held the last entry, after the map lost one. */
+  void WriteCount();
+
+  BufferPoolManager *bpm_;
+  /** The chain of map pages, in order. */
+  std::vector<page_id_t> map_page_ids_;
+  /** The heap page at each slot of the map pages. */
+  std::vector<page_id_t> slots_;
+  std::unordered_map<page_id_t, PageInfo> pages_;
+  std::array<std::set<page_id_t>, CATEGORY_COUNT> buckets_;
+};
+
+}  // namespace bustub
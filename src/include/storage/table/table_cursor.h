@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_cursor.h
+//
+// Identification: src/include/storage/table/table_cursor.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include "buffer/scan_prefetcher.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/page/table_page.h"
+#include "storage/table/table_iterator.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+class TableHeap;
+
+/**
+ * TableCursor scans a TableHeap a page at a time. It visits the same tuples as the TableIterator it is made from, but
+ * skips deleted ones.
+ *
+ * On entering a page the cursor copies it under a single read latch, and then serves every slot of the page from the
+ * copy. A TableIterator fetches the page again for every tuple, and once more to read it.
+ *
+ * The page is copied rather than kept pinned and latched, because the operators above a scan write to the pages it
+ * reads: an update or a delete would wait forever for a latch the scan holds.
+ *
+ * A tuple whose slot forwards to another page, see TableHeap::UpdateTuple, is read through the heap instead.
+ */
+class TableCursor {
+ public:
+  DISALLOW_COPY(TableCursor);
+
+  /** Take over the position and the stopping point of iter. */
+  explicit TableCursor(TableIterator &&iter);
+  TableCursor(TableCursor &&) = default;
+
+  ~TableCursor() = default;
+
+  /**
+   * Move to the next tuple that is not deleted. A new cursor is before its first tuple.
+   * @return false if there is none
+   */
+  auto Next() -> bool;
+
+  /** @return the RID of the current tuple */
+  auto GetRID() const -> RID { return {page_id_, slot_}; }
+
+  /** @return the meta of the current tuple, as of when the cursor entered its page */
+  auto GetTupleMeta() const -> TupleMeta;
+
+  /** @return a view of the current tuple, valid until the cursor moves on */
+  auto GetTupleView() const -> TupleView;
+
+  /** Copy the current tuple into tuple, reusing the memory it already has. */
+  void GetTuple(Tuple *tuple) const;
+
+ private:
+  /** Copy page_id in and point the cursor at its first slot, or past the end of the heap if it is INVALID_PAGE_ID. */
+  void LoadPage(page_id_t page_id);
+
+  auto Page() const -> const TablePage * { return reinterpret_cast<const TablePage *>(page_data_.get()); }
+
+  TableHeap *table_heap_;
+  RID stop_at_rid_;
+  std::unordered_map<page_id_t, uint32_t> tuple_counts_;
+  std::shared_ptr<void> scan_token_;
+  ScanPrefetcher prefetcher_;
+
+  /** The copy of the current page. */
+  std::unique_ptr<char[]> page_data_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  /** The page after the current one, or INVALID_PAGE_ID if the cursor stops with the current one. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** The number of slots of the current page the cursor visits. */
+  uint32_t num_tuples_{0};
+  /** The slot of the current tuple. */
+  uint32_t slot_{0};
+  /** The slot to look at next. */
+  uint32_t next_slot_{0};
+  /** The current tuple, if its slot forwards to another page. */
+  std::optional<std::pair<TupleMeta, Tuple>> forwarded_;
+};
+
+}  // namespace bustub
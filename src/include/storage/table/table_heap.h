@@ -12,9 +12,17 @@
 
 #pragma once
 
-#include <mutex>  // NOLINT
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <limits>
+#include <memory>
+#include <mutex>   // NOLINT
 #include <optional>
+#include <thread>  // NOLINT
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -22,6 +30,7 @@
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -30,12 +39,19 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Inserts go to one of TABLE_HEAP_INSERT_TARGETS target pages, picked by the inserting thread, so that concurrent
+ * inserters fill different pages. A target whose page is full gives it to the free space map and takes the page from
+ * the map that fits the tuple best, or a new page at the end of the heap if none does.
+ *
+ * Deleted tuples keep their space until Vacuum reclaims it.
  */
 class TableHeap {
   friend class TableIterator;
+  friend class TableCursor;
 
  public:
-  ~TableHeap() = default;
+  ~TableHeap();
 
   /**
    * Create a table heap without a transaction. (open table)
@@ -63,9 +79,20 @@ class TableHeap {
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
+   * @param access_type type of access to the page of the tuple
    * @return the meta and tuple
    */
-  auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
+  auto GetTuple(RID rid, AccessType access_type = AccessType::Unknown) -> std::pair<TupleMeta, Tuple>;
+
+  /**
+   * Read several tuples from the table. The pages of the tuples are fetched together, see
+   * BufferPoolManager::FetchPages.
+   * @param rids rids of the tuples to read
+   * @param access_type type of access to the pages of the tuples
+   * @return the meta and tuple of every rid, in the order of rids
+   */
+  auto GetTuples(const std::vector<RID> &rids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<std::pair<TupleMeta, Tuple>>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
@@ -84,6 +111,18 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /**
+   * Update a tuple, in place if its page has room for the new data. A tuple that outgrows its page moves to another
+   * one, and its slot forwards readers there, so that its RID, and the index entries that point to it, stay valid.
+   * Updates and deletes of the same tuple must not run concurrently.
+   * @param meta new tuple meta, not deleted
+   * @param tuple new tuple
+   * @param rid the rid of the tuple to update
+   * @return the rid of the tuple from now on. That is rid, unless the tuple was smaller than a RID and its page had no
+   * room to forward it; then it was deleted and inserted again, and a scan that is still running may reach it again.
+   */
+  auto UpdateTuple(const TupleMeta &meta, const Tuple &tuple, RID rid) -> RID;
+
   /**
    * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4.
    * @param meta new tuple meta
@@ -92,12 +131,94 @@ class TableHeap {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Reclaim the space of deleted tuples, going through the pages of the heap from where the last call stopped.
+   *
+   * Every page is compacted, see TablePage::Compact, and its new free space recorded in the free space map. A page
+   * whose tuples are all deleted is unlinked from the heap instead. The first and the last page, and the pages of the
+   * targets, are never unlinked.
+   *
+   * Iterators may be on an unlinked page, and don't bound the tuples they visit of pages that were too full to be in
+   * the map when they were made. So unlinked pages are only deleted from the buffer pool, and the space of pages that
+   * were too full is only given to the map, by a later call that finds no iterator open.
+   *
+   * @param max_pages the number of pages to go through at most. A call that starts at the first page stops at the end
+   * of the heap; with 0, a call only finishes the pages of earlier calls.
+   * @return the number of pages deleted
+   */
+  auto Vacuum(size_t max_pages = std::numeric_limits<size_t>::max()) -> size_t;
+
+  /**
+   * Start a background thread that runs Vacuum over TABLE_HEAP_VACUUM_BATCH_PAGES pages every
+   * table_heap_vacuum_interval, while a pass is under way or a tuple was deleted since the last one started.
+   */
+  void StartBackgroundVacuum();
+
+  /** Stop the background vacuum and wait for it to exit. Does nothing if it is not running. */
+  void StopBackgroundVacuum();
+
  private:
+  /** A page open to inserts, and the latch that inserters into it take first. */
+  struct InsertTarget {
+    std::mutex latch_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /**
+   * Insert a tuple into the page of the target of this thread, see InsertTuple.
+   * @return the page of the tuple, still write latched, and its rid
+   */
+  auto InsertIntoTarget(const TupleMeta &meta, const Tuple &tuple) -> std::pair<WritePageGuard, RID>;
+
+  /**
+   * Swap the full page of a target for one with room for a tuple of tuple_size bytes. Must hold the latch of the
+   * target, and no page latch.
+   * @param target the target, whose page is full or INVALID_PAGE_ID
+   * @param free_space the free space of the full page
+   * @param num_tuples the number of tuples of the full page
+   * @return the new page of the target, write latched
+   */
+  auto SwapTargetPage(InsertTarget *target, size_t free_space, uint32_t num_tuples, size_t tuple_size)
+      -> WritePageGuard;
+
+  /** @return true if page_id is the page of a target. Must hold latch_. */
+  auto IsTargetPage(page_id_t page_id) const -> bool;
+
+  /**
+   * Delete the unlinked pages and give the compacted pages to the free space map, if no iterator is open. Must hold
+   * vacuum_latch_.
+   * @return the number of pages deleted
+   */
+  auto FinishVacuumedPages() -> size_t;
+
+  void RunBackgroundVacuum();
+
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
+  std::array<InsertTarget, TABLE_HEAP_INSERT_TARGETS> targets_;
+
+  /** Latched after the latch of a target, never before. */
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  FreeSpaceMap free_space_map_;             /* protected by latch_ */
+  /** Copied into every iterator under latch_, so that no iterator is open while only the heap holds it. */
+  std::shared_ptr<void> scan_token_;
+
+  /** Latched before latch_, by one Vacuum at a time. */
+  std::mutex vacuum_latch_;
+  /** The page Vacuum goes on from, or INVALID_PAGE_ID to start a new pass, and the page before it. */
+  page_id_t vacuum_page_id_{INVALID_PAGE_ID};      /* protected by vacuum_latch_ */
+  page_id_t vacuum_prev_page_id_{INVALID_PAGE_ID}; /* protected by vacuum_latch_ */
+  std::vector<page_id_t> unlinked_pages_;          /* protected by vacuum_latch_ */
+  /** Pages that were too full to be in the free space map before Vacuum compacted them. */
+  std::unordered_set<page_id_t> compacted_pages_; /* protected by vacuum_latch_ */
+
+  std::atomic<bool> vacuum_pending_{false};
+  std::atomic<bool> enable_background_vacuum_{false};
+  std::thread *background_vacuum_thread_{nullptr};
+  std::mutex background_vacuum_latch_;
+  std::condition_variable background_vacuum_cv_;
 };
 
 }  // namespace bustub
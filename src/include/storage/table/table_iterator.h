@@ -14,8 +14,10 @@
 
 #include <cassert>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
+#include "buffer/scan_prefetcher.h"
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
@@ -26,15 +28,23 @@ namespace bustub {
 class TableHeap;
 
 /**
- * TableIterator enables the sequential scan of a TableHeap.
+ * TableIterator enables the sequential scan of a TableHeap. Its pages are fetched as AccessType::Scan, and the next
+ * SCAN_READAHEAD_DEPTH pages of the heap are prefetched ahead of it.
  */
 class TableIterator {
-  friend class Cursor;
+  friend class TableCursor;
 
  public:
   DISALLOW_COPY(TableIterator);
 
-  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
+  /**
+   * @param rid the first tuple to visit, or the first after it that exists
+   * @param stop_at_rid the tuple to stop at, or {INVALID_PAGE_ID, 0} to scan to the end of the heap
+   * @param tuple_counts the number of tuples to visit of pages that inserts could still add tuples to
+   * @param scan_token keeps the pages the iterator may visit from being deleted, see TableHeap::Vacuum
+   */
+  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid,
+                std::unordered_map<page_id_t, uint32_t> tuple_counts = {}, std::shared_ptr<void> scan_token = nullptr);
   TableIterator(TableIterator &&) = default;
 
   ~TableIterator() = default;
@@ -48,6 +58,9 @@ class TableIterator {
   auto operator++() -> TableIterator &;
 
  private:
+  /** Move rid_ to the first tuple at or after it that the iterator visits, or to the end. */
+  void SeekTuple();
+
   TableHeap *table_heap_;
   RID rid_;
 
@@ -55,6 +68,14 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  // Inserts go to several pages, not only to the last one (see TableHeap). The iterator stops at the number of tuples
+  // those had when it was created, too.
+  std::unordered_map<page_id_t, uint32_t> tuple_counts_;
+
+  std::shared_ptr<void> scan_token_;
+
+  ScanPrefetcher prefetcher_;
 };
 
 }  // namespace bustub
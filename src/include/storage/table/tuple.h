@@ -52,6 +52,8 @@ class Tuple {
   friend class TablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TableCursor;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -112,4 +114,43 @@ class Tuple {
   std::vector<char> data_;
 };
 
+/**
+ * TupleView reads a tuple in place, wherever its bytes are: in a page, in a copy of one (see TableCursor), or in a
+ * Tuple. It does not own the bytes, and is only valid as long as they are.
+ *
+ * Values and expressions are read from a view the same way as from a Tuple, so an operator can look at a row without
+ * copying it, and call ToTuple only for the rows it keeps.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  TupleView(const char *data, uint32_t length, RID rid = RID{}) : data_(data), length_(length), rid_(rid) {}
+
+  // A Tuple can be passed wherever a view is taken.
+  TupleView(const Tuple &tuple)  // NOLINT
+      : data_(tuple.data_.data()), length_(tuple.data_.size()), rid_(tuple.rid_) {}
+
+  inline auto GetRid() const -> RID { return rid_; }
+
+  inline auto GetData() const -> const char * { return data_; }
+
+  inline auto GetLength() const -> uint32_t { return length_; }
+
+  // Get the value of a specified column, see Tuple::GetValue
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
+    return GetValue(schema, column_idx).IsNull();
+  }
+
+  /** @return a Tuple holding a copy of the bytes */
+  auto ToTuple() const -> Tuple;
+
+ private:
+  const char *data_{nullptr};
+  uint32_t length_{0};
+  RID rid_{};
+};
+
 }  // namespace bustub
@@ -0,0 +1,170 @@
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Split a predicate into the terms of its top-level conjunction. */
+void CollectConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    CollectConjuncts(logic_expr->children_[0], conjuncts);
+    CollectConjuncts(logic_expr->children_[1], conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+/** Flip a comparison for swapped operands, so that `5 < x` reads `x > 5`. */
+auto FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** The range of a column that a predicate allows, narrowed one comparison at a time. */
+struct KeyRange {
+  std::optional<Value> lower_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_;
+  bool upper_inclusive_{true};
+
+  void NarrowLower(const Value &value, bool inclusive) {
+    if (!lower_.has_value() || value.CompareGreaterThan(*lower_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*lower_) == CmpBool::CmpTrue && !inclusive)) {
+      lower_ = value;
+      lower_inclusive_ = inclusive;
+    }
+  }
+
+  void NarrowUpper(const Value &value, bool inclusive) {
+    if (!upper_.has_value() || value.CompareLessThan(*upper_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*upper_) == CmpBool::CmpTrue && !inclusive)) {
+      upper_ = value;
+      upper_inclusive_ = inclusive;
+    }
+  }
+
+  /** Narrow the range by `column comp_type value`. @return false if the comparison can't bound the column */
+  auto Narrow(ComparisonType comp_type, const Value &value) -> bool {
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        NarrowLower(value, true);
+        NarrowUpper(value, true);
+        return true;
+      case ComparisonType::LessThan:
+        NarrowUpper(value, false);
+        return true;
+      case ComparisonType::LessThanOrEqual:
+        NarrowUpper(value, true);
+        return true;
+      case ComparisonType::GreaterThan:
+        NarrowLower(value, false);
+        return true;
+      case ComparisonType::GreaterThanOrEqual:
+        NarrowLower(value, true);
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+}  // namespace
+
+auto Optimizer::OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // Writes change the index under the scan, which could then see a row twice or skip one. An insert that reads its
+  // own table would keep finding the rows it just inserted.
+  if (plan->GetType() == PlanType::Insert || plan->GetType() == PlanType::Update ||
+      plan->GetType() == PlanType::Delete) {
+    return plan;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Filter) {
+    return optimized_plan;
+  }
+  const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+  BUSTUB_ENSURE(filter_plan.children_.size() == 1, "Filter with multiple children?? Impossible!");
+  if (filter_plan.GetChildPlan()->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*filter_plan.GetChildPlan());
+  if (seq_scan.filter_predicate_ != nullptr) {
+    return optimized_plan;
+  }
+
+  std::vector<AbstractExpressionRef> conjuncts;
+  CollectConjuncts(filter_plan.GetPredicate(), &conjuncts);
+
+  for (const auto *index_info : catalog_.GetTableIndexes(seq_scan.table_name_)) {
+    const auto &key_attrs = index_info->index_->GetKeyAttrs();
+    if (key_attrs.size() != 1) {
+      continue;
+    }
+    KeyRange range;
+    bool bounded = false;
+    for (const auto &conjunct : conjuncts) {
+      const auto *comp_expr = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+      if (comp_expr == nullptr) {
+        continue;
+      }
+      auto comp_type = comp_expr->comp_type_;
+      const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->children_[0].get());
+      const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(comp_expr->children_[1].get());
+      if (column_expr == nullptr || constant_expr == nullptr) {
+        column_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->children_[1].get());
+        constant_expr = dynamic_cast<const ConstantValueExpression *>(comp_expr->children_[0].get());
+        comp_type = FlipComparison(comp_type);
+      }
+      if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetColIdx() != key_attrs[0]) {
+        continue;
+      }
+      // The index compares raw keys, so the constant must already be of the column's type.
+      const auto &value = constant_expr->val_;
+      if (value.IsNull() || value.GetTypeId() != column_expr->GetReturnType()) {
+        continue;
+      }
+      bounded |= range.Narrow(comp_type, value);
+    }
+    if (bounded) {
+      // The filter stays on top: the range only covers the terms on the indexed column.
+      auto index_scan = std::make_shared<IndexScanPlanNode>(seq_scan.output_schema_, index_info->index_oid_,
+                                                            range.lower_, range.lower_inclusive_, range.upper_,
+                                                            range.upper_inclusive_);
+      return optimized_plan->CloneWithChildren({std::move(index_scan)});
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -11,9 +11,13 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   auto p = plan;
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
+  p = OptimizeNLJAsIndexJoin(p);
   p = OptimizeNLJAsHashJoin(p);
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeFilterAsIndexScan(p);
   p = OptimizeSortLimitAsTopN(p);
+  // Last, so that the rules above still see the filters they turn into index scans and joins.
+  p = OptimizeMergeFilterScan(p);
   return p;
 }
 
@@ -33,9 +33,10 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &order_bys = sort_plan.GetOrderBy();
 
     std::vector<uint32_t> order_by_column_ids;
+    // Either every order type is asc or default, or every one is desc, which the index can serve backward.
+    const bool reverse = !order_bys.empty() && order_bys[0].first == OrderByType::DESC;
     for (const auto &[order_type, expr] : order_bys) {
-      // Order type is asc or default
-      if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+      if ((order_type == OrderByType::DESC) != reverse || order_type == OrderByType::INVALID) {
         return optimized_plan;
       }
 
@@ -68,8 +69,13 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
               break;
             }
           }
+          // Only the leaves of BPlusTree are linked both ways.
+          if (reverse && dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index->index_.get()) == nullptr &&
+              dynamic_cast<BPlusTreePostingIndex *>(index->index_.get()) == nullptr) {
+            valid = false;
+          }
           if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_, reverse);
           }
         }
       }
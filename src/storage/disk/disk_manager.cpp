@@ -79,11 +79,11 @@ void DiskManager::ShutDown() {
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
+  size_t offset = static_cast<size_t>(page_id) * bustub_page_size;
   // set write cursor to offset
   num_writes_ += 1;
   db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
+  db_io_.write(page_data, bustub_page_size);
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
@@ -98,7 +98,7 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
+  int offset = page_id * bustub_page_size;
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file, pageid : %d", page_id);
@@ -106,22 +106,69 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   } else {
     // set read cursor to offset
     db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
+    db_io_.read(page_data, bustub_page_size);
     if (db_io_.bad()) {
       LOG_DEBUG("I/O error while reading");
       return;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
+    // if file ends before reading bustub_page_size
     int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
+    if (read_count < bustub_page_size) {
       LOG_DEBUG("Read less than a page");
       db_io_.clear();
       // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      memset(page_data + read_count, 0, bustub_page_size - read_count);
     }
   }
 }
 
+void DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, Callback callback) {
+  WritePage(page_id, page_data);
+  callback(true);
+}
+
+void DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, Callback callback) {
+  ReadPage(page_id, page_data);
+  callback(true);
+}
+
+void DiskManager::ReadPagesAsync(page_id_t first_page_id, std::vector<char *> page_data, Callback callback) {
+  // Disk managers that keep their pages somewhere else only implement ReadPage.
+  if (!db_io_.is_open()) {
+    for (size_t i = 0; i < page_data.size(); i++) {
+      ReadPage(first_page_id + static_cast<page_id_t>(i), page_data[i]);
+    }
+    callback(true);
+    return;
+  }
+
+  bool success = true;
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    int64_t offset = static_cast<int64_t>(first_page_id) * bustub_page_size;
+    int64_t file_size = GetFileSize(file_name_);
+    db_io_.seekg(offset);
+    for (char *data : page_data) {
+      int read_count = 0;
+      if (success && offset < file_size) {
+        db_io_.read(data, bustub_page_size);
+        if (db_io_.bad()) {
+          LOG_DEBUG("I/O error while reading");
+          success = false;
+        }
+        read_count = db_io_.gcount();
+      }
+      // The rest of the run lies beyond the end of the file.
+      if (read_count < bustub_page_size) {
+        db_io_.clear();
+        memset(data + read_count, 0, bustub_page_size - read_count);
+      }
+      offset += bustub_page_size;
+    }
+  }
+  callback(success);
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
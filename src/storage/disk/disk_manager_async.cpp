@@ -0,0 +1,444 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_async.cpp
+//
+// Identification: src/storage/disk/disk_manager_async.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_async.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define BUSTUB_HAS_IO_URING
+#endif
+
+namespace bustub {
+
+/** Number of pread/pwrite threads of the fallback path. */
+static constexpr size_t MAX_FALLBACK_WORKERS = 16;
+/** Longest wait between retries of a system call that keeps failing. */
+static constexpr std::chrono::milliseconds MAX_RETRY_BACKOFF{100};
+
+/** Wait before retrying a system call that failed failures times in a row, doubling the wait each time. */
+static void BackOff(int failures) {
+  std::this_thread::sleep_for(std::min(std::chrono::milliseconds(1 << std::min(failures, 7)), MAX_RETRY_BACKOFF));
+}
+
+/** @return true if a system call that failed with err may succeed right away when retried */
+static auto IsTransient(int err) -> bool { return err == EINTR || err == EAGAIN || err == EBUSY; }
+
+DiskManagerAsync::DiskManagerAsync(const std::string &db_file, size_t queue_depth, bool direct_io)
+    : DiskManager(db_file), queue_depth_(std::max<size_t>(queue_depth, 1)), direct_io_(direct_io) {
+  // The base class opened the log file and a stream on the database file. Pages go through db_fd_ instead.
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    db_io_.close();
+  }
+
+  int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+  }
+#endif
+  if (db_fd_ < 0) {
+    // Either O_DIRECT was not requested or the file system (e.g. tmpfs) rejected it.
+    direct_io_ = false;
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+    if (db_fd_ < 0) {
+      throw Exception("can't open db file");
+    }
+  }
+
+  if (SetUpRing()) {
+    reaper_ = std::thread([this] { ReapCompletions(); });
+  } else {
+    size_t num_workers = std::min(queue_depth_, MAX_FALLBACK_WORKERS);
+    for (size_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back([this] { RunWorker(); });
+    }
+  }
+}
+
+DiskManagerAsync::~DiskManagerAsync() { ShutDown(); }
+
+void DiskManagerAsync::ShutDown() {
+  if (shut_down_.exchange(true)) {
+    return;
+  }
+  {
+    std::unique_lock lock(inflight_latch_);
+    inflight_cv_.wait(lock, [&] { return inflight_ == 0; });
+  }
+
+  if (reaper_.joinable()) {
+    SubmitToRing(nullptr);
+    reaper_.join();
+  }
+  queue_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+
+#ifdef BUSTUB_HAS_IO_URING
+  if (ring_fd_ >= 0) {
+    munmap(sqes_, sqes_size_);
+    if (cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+#endif
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+/**
+ * Write the contents of the specified page into disk file, waiting for the I/O to finish
+ */
+void DiskManagerAsync::WritePage(page_id_t page_id, const char *page_data) {
+  // The promise is shared with the callback, which may still be returning from set_value when get() wakes up.
+  auto done = std::make_shared<std::promise<bool>>();
+  auto result = done->get_future();
+  WritePageAsync(page_id, page_data, [done](bool success) { done->set_value(success); });
+  if (!result.get()) {
+    LOG_DEBUG("I/O error while writing");
+  }
+}
+
+/**
+ * Read the contents of the specified page into the given memory area, waiting for the I/O to finish
+ */
+void DiskManagerAsync::ReadPage(page_id_t page_id, char *page_data) {
+  // The promise is shared with the callback, which may still be returning from set_value when get() wakes up.
+  auto done = std::make_shared<std::promise<bool>>();
+  auto result = done->get_future();
+  ReadPageAsync(page_id, page_data, [done](bool success) { done->set_value(success); });
+  if (!result.get()) {
+    LOG_DEBUG("I/O error while reading");
+  }
+}
+
+void DiskManagerAsync::WritePageAsync(page_id_t page_id, const char *page_data, Callback callback) {
+  // The buffer is only read for a write request.
+  Submit(new Request{true, page_id, const_cast<char *>(page_data), nullptr, std::move(callback)});  // NOLINT
+}
+
+void DiskManagerAsync::ReadPageAsync(page_id_t page_id, char *page_data, Callback callback) {
+  Submit(new Request{false, page_id, page_data, nullptr, std::move(callback)});
+}
+
+void DiskManagerAsync::ReadPagesAsync(page_id_t first_page_id, std::vector<char *> page_data, Callback callback) {
+  if (page_data.size() == 1) {
+    ReadPageAsync(first_page_id, page_data[0], std::move(callback));
+    return;
+  }
+  auto *request = new Request{false, first_page_id, nullptr, nullptr, std::move(callback)};
+  for (char *data : page_data) {
+    request->iov_.push_back({data, static_cast<size_t>(bustub_page_size)});
+  }
+  Submit(request);
+}
+
+void DiskManagerAsync::AcquireSlot() {
+  std::unique_lock lock(inflight_latch_);
+  inflight_cv_.wait(lock, [&] { return inflight_ < queue_depth_; });
+  inflight_++;
+}
+
+void DiskManagerAsync::ReleaseSlot(bool was_write) {
+  std::scoped_lock lock(inflight_latch_);
+  inflight_--;
+  if (was_write) {
+    num_writes_ += 1;
+  }
+  inflight_cv_.notify_all();
+}
+
+void DiskManagerAsync::Submit(Request *request) {
+  BUSTUB_ASSERT(!shut_down_, "request submitted after ShutDown");
+  auto aligned = [](const void *data) { return reinterpret_cast<uintptr_t>(data) % bustub_page_size == 0; };
+  bool needs_bounce = request->iov_.empty()
+                          ? !aligned(request->data_)
+                          : std::any_of(request->iov_.begin(), request->iov_.end(),
+                                        [&](const iovec &iov) { return !aligned(iov.iov_base); });
+  if (direct_io_ && needs_bounce) {
+    size_t length = request->NumPages() * bustub_page_size;
+    request->bounce_ = static_cast<char *>(std::aligned_alloc(bustub_page_size, length));
+    if (request->is_write_) {
+      memcpy(request->bounce_, request->data_, bustub_page_size);
+    }
+  }
+
+  AcquireSlot();
+  Dispatch(request);
+}
+
+void DiskManagerAsync::Dispatch(Request *request) {
+  if (ring_fd_ >= 0) {
+    SubmitToRing(request);
+    return;
+  }
+  {
+    std::scoped_lock lock(queue_latch_);
+    queue_.push_back(request);
+  }
+  queue_cv_.notify_one();
+}
+
+void DiskManagerAsync::Complete(Request *request, int64_t result) {
+  bool success = result >= 0;
+  if (!success) {
+    LOG_DEBUG("I/O error on page %d: %s", request->page_id_, strerror(static_cast<int>(-result)));
+  }
+  if (success && request->is_write_) {
+    request->written_ += result;
+    if (request->written_ < static_cast<size_t>(bustub_page_size)) {
+      // A write that makes no progress at all would never finish.
+      if (result > 0) {
+        Dispatch(request);
+        return;
+      }
+      LOG_DEBUG("short write on page %d", request->page_id_);
+      success = false;
+    }
+  }
+  if (!request->is_write_) {
+    // Reading past the end of the file leaves the rest of the pages zeroed, like DiskManager::ReadPage.
+    auto read_count = static_cast<size_t>(std::max<int64_t>(result, 0));
+    for (size_t i = 0; i < request->NumPages(); i++) {
+      char *page = request->iov_.empty() ? request->data_ : static_cast<char *>(request->iov_[i].iov_base);
+      char *buffer = request->bounce_ != nullptr ? request->bounce_ + i * bustub_page_size : page;
+      size_t page_read_count = std::min<size_t>(read_count, bustub_page_size);
+      read_count -= page_read_count;
+      if (page_read_count < static_cast<size_t>(bustub_page_size)) {
+        memset(buffer + page_read_count, 0, bustub_page_size - page_read_count);
+      }
+      if (request->bounce_ != nullptr) {
+        memcpy(page, buffer, bustub_page_size);
+      }
+    }
+  }
+  std::free(request->bounce_);  // NOLINT
+
+  // Free the slot before running the callback, the callback may well issue the next request.
+  ReleaseSlot(request->is_write_);
+  request->callback_(success);
+  delete request;
+}
+
+void DiskManagerAsync::RunWorker() {
+  while (true) {
+    Request *request;
+    {
+      std::unique_lock lock(queue_latch_);
+      queue_cv_.wait(lock, [&] { return !queue_.empty() || shut_down_; });
+      if (queue_.empty()) {
+        return;
+      }
+      request = queue_.front();
+      queue_.pop_front();
+    }
+    char *buffer = request->bounce_ != nullptr ? request->bounce_ : request->data_;
+    off_t offset = static_cast<off_t>(request->page_id_) * bustub_page_size;
+    size_t length = request->NumPages() * bustub_page_size;
+    ssize_t result;
+    if (request->is_write_) {
+      result = pwrite(db_fd_, buffer + request->written_, length - request->written_, offset + request->written_);
+    } else if (!request->iov_.empty() && request->bounce_ == nullptr) {
+      result = preadv(db_fd_, request->iov_.data(), static_cast<int>(request->iov_.size()), offset);
+    } else {
+      result = pread(db_fd_, buffer, length, offset);
+    }
+    Complete(request, result < 0 ? -errno : result);
+  }
+}
+
+#ifdef BUSTUB_HAS_IO_URING
+
+auto DiskManagerAsync::SetUpRing() -> bool {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth_), &params));
+  if (fd < 0) {
+    LOG_DEBUG("io_uring unavailable (%s), falling back to a thread pool", strerror(errno));
+    return false;
+  }
+  // IORING_OP_READ / IORING_OP_WRITE were added together with this feature flag (Linux 5.6).
+  if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+    LOG_DEBUG("io_uring too old, falling back to a thread pool");
+    close(fd);
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+      close(fd);
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    if (cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(fd);
+    return false;
+  }
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  auto *cq = static_cast<char *>(cq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  ring_fd_ = fd;
+  return true;
+}
+
+void DiskManagerAsync::SubmitToRing(Request *request) {
+  std::unique_lock lock(sq_latch_);
+  // At most queue_depth_ requests (plus the final no-op) are in flight, so the submission queue never overflows.
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  if (request == nullptr) {
+    sqe->opcode = IORING_OP_NOP;
+  } else {
+    sqe->fd = db_fd_;
+    sqe->off = static_cast<uint64_t>(request->page_id_) * bustub_page_size + request->written_;
+    if (!request->iov_.empty() && request->bounce_ == nullptr) {
+      sqe->opcode = IORING_OP_READV;
+      sqe->addr = reinterpret_cast<uint64_t>(request->iov_.data());
+      sqe->len = request->iov_.size();
+    } else {
+      sqe->opcode = request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+      char *buffer = request->bounce_ != nullptr ? request->bounce_ : request->data_;
+      sqe->addr = reinterpret_cast<uint64_t>(buffer + request->written_);
+      sqe->len = request->NumPages() * bustub_page_size - request->written_;
+    }
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  sq_pending_++;
+
+  // If another thread is already inside io_uring_enter it will pick up this entry too, so concurrent requests end up
+  // in a single system call.
+  if (sq_submitting_) {
+    return;
+  }
+  sq_submitting_ = true;
+  int failures = 0;
+  while (sq_pending_ > 0) {
+    unsigned to_submit = sq_pending_;
+    lock.unlock();
+    int submitted = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, 0, 0, nullptr, 0));
+    int err = errno;
+    if (submitted < 0 && !IsTransient(err)) {
+      LOG_DEBUG("io_uring_enter failed: %s", strerror(err));
+      BackOff(failures++);
+    }
+    lock.lock();
+    if (submitted < 0) {
+      continue;
+    }
+    failures = 0;
+    sq_pending_ -= submitted;
+  }
+  sq_submitting_ = false;
+}
+
+void DiskManagerAsync::ReapCompletions() {
+  bool stop = false;
+  int failures = 0;
+  while (!stop) {
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+    // The requests in flight can only complete through this thread, so it keeps trying, but without spinning on an
+    // error that won't go away.
+    if (ret < 0 && !IsTransient(errno)) {
+      LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+      BackOff(failures++);
+    } else {
+      failures = 0;
+    }
+    // This thread is the only consumer of the completion queue.
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+      auto *cqe = static_cast<io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+      auto *request = reinterpret_cast<Request *>(cqe->user_data);
+      int64_t result = cqe->res;
+      head++;
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      if (request == nullptr) {
+        stop = true;
+      } else {
+        Complete(request, result);
+      }
+    }
+  }
+}
+
+#else
+
+auto DiskManagerAsync::SetUpRing() -> bool { return false; }
+
+void DiskManagerAsync::SubmitToRing(Request *request) { UNREACHABLE("io_uring is not supported on this platform"); }
+
+void DiskManagerAsync::ReapCompletions() {}
+
+#endif
+
+}  // namespace bustub
@@ -1,6 +1,10 @@
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -8,11 +12,13 @@
 #include "common/macros.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/int_key_search.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/b_plus_tree_page.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/posting_list_page.h"
 
 namespace bustub {
 
@@ -30,9 +36,20 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
   root_page->root_page_id_ = INVALID_PAGE_ID;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopBackgroundCompaction(); }
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::KeyIndex(const KeyType &key,
                               const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *node) const -> int {
+  if constexpr (IsIntegerKeyComparator<KeyComparator>::value) {
+    int shift = comparator_.RawShift();
+    if (shift >= 0 && node->GetSize() > 0) {
+      int i = IntKeyLowerBound(reinterpret_cast<const char *>(&node->ArrayAt(0).first), sizeof(node->ArrayAt(0)),
+                               node->GetSize(), comparator_.RawKey(key), shift);
+      return std::min(i, node->GetSize() - 1);
+    }
+  }
   int l = 0;
   int r = node->GetSize() - 1;
   while (l < r) {
@@ -49,6 +66,14 @@ auto BPLUSTREE_TYPE::KeyIndex(const KeyType &key,
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::KeyIndex(const KeyType &key,
                               const BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *node) const -> int {
+  if constexpr (IsIntegerKeyComparator<KeyComparator>::value) {
+    int shift = comparator_.RawShift();
+    if (shift >= 0 && node->GetSize() > 0) {
+      int i = IntKeyLowerBound(reinterpret_cast<const char *>(&node->ArrayAt(0).first), sizeof(node->ArrayAt(0)),
+                               node->GetSize(), comparator_.RawKey(key), shift);
+      return std::min(i, node->GetSize() - 1);
+    }
+  }
   int l = 0;
   int r = node->GetSize() - 1;
   while (l < r) {
@@ -184,6 +209,7 @@ auto BPLUSTREE_TYPE::MergeNode(BPlusTreeInternalPage<KeyType, page_id_t, KeyComp
     }
     lbro_node->SetSize(lbro_node->GetSize() + childnode->GetSize());
     lbro_node->SetNextPageId(childnode->GetNextPageId());
+    SetLeafPrevPageId(childnode->GetNextPageId(), pg_guard.PageId());
     fatherNode->SetValueAt(pos, pg_guard.PageId());
     childnode->SetSize(0);
     DeleteKey(old_bro_key, fatherNode);
@@ -200,6 +226,7 @@ auto BPLUSTREE_TYPE::MergeNode(BPlusTreeInternalPage<KeyType, page_id_t, KeyComp
 
     childnode->SetSize(rbro_node->GetSize() + childnode->GetSize());
     childnode->SetNextPageId(rbro_node->GetNextPageId());
+    SetLeafPrevPageId(rbro_node->GetNextPageId(), fatherNode->ValueAt(pos));
     DeleteKey(old_bro_key, fatherNode);
     fatherNode->SetKeyAt(pos, old_bro_key);
     page_id_t drop = pg_guard.PageId();
@@ -273,6 +300,17 @@ auto BPLUSTREE_TYPE::MergeNode(BPlusTreeInternalPage<KeyType, page_id_t, KeyComp
   BUSTUB_ASSERT(false, "error branch in merge");
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetLeafPrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  // Called with page_id's left neighbour latched. Leaves under different parents are only latched left to right, and
+  // leaves under the same parent only with the parent write latched, so this can't deadlock.
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  guard.AsMut<LeafPage>()->SetPrevPageId(prev_page_id);
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -288,17 +326,12 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return this->GetRootPageId() == I
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  if (IsEmpty()) {
-    return false;
-  }
   // Declaration of context instance.
   // Context ctx;
-  ReadPageGuard iter_pageguard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = iter_pageguard.As<BPlusTreeHeaderPage>();
-  // ctx.root_page_id_ = root_page->root_page_id_;
-  // ctx.header_page_ = std::move(guard);
-
-  iter_pageguard = bpm_->FetchPageRead(root_page->root_page_id_);
+  ReadPageGuard iter_pageguard = FetchRootRead();
+  if (!iter_pageguard.IsValid()) {
+    return false;
+  }
   auto iter_page = iter_pageguard.As<BPlusTreePage>();
 
   while (!iter_page->IsLeafPage()) {
@@ -334,6 +367,233 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   // return false;
 }
 
+/*
+ * Look up a batch of keys, sharing leaves between neighbouring keys. Only the
+ * current leaf stays read latched between keys, along with the separator its
+ * parent keeps for it. A key past it descends again from the root, releasing
+ * each page once its child is latched, so that writers that need the upper
+ * levels never wait for the whole batch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *txn) {
+  results->resize(keys.size());
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this, &keys](size_t a, size_t b) { return comparator_(keys[a], keys[b]) < 0; });
+
+  // leaf_separator is the largest key the leaf can hold, std::nullopt if the leaf is the root.
+  ReadPageGuard leaf_guard;
+  std::optional<KeyType> leaf_separator;
+  for (size_t pos = 0; pos < order.size(); pos++) {
+    const KeyType &key = keys[order[pos]];
+    if (leaf_guard.IsValid() && leaf_separator.has_value() && comparator_(key, *leaf_separator) > 0) {
+      // Pages are latched from the root down, so the leaf goes before the root is latched again.
+      leaf_guard.Drop();
+    }
+    if (!leaf_guard.IsValid()) {
+      ReadPageGuard guard = FetchRootRead();
+      if (!guard.IsValid()) {
+        return;
+      }
+      leaf_separator = std::nullopt;
+      while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+        const auto *internal_page = guard.As<InternalPage>();
+        int i = KeyIndex(key, internal_page);
+        // key is larger than every key in the tree, and so are the keys after it.
+        if (comparator_(key, internal_page->KeyAt(i)) > 0) {
+          return;
+        }
+        // Prefetch the next few children the rest of the batch will visit, while this one is being read.
+        int last = i;
+        int prefetched = 0;
+        for (size_t next = pos + 1; next < order.size() && prefetched < SCAN_READAHEAD_DEPTH; next++) {
+          const KeyType &next_key = keys[order[next]];
+          if (comparator_(next_key, internal_page->KeyAt(internal_page->GetSize() - 1)) > 0) {
+            break;
+          }
+          int child = KeyIndex(next_key, internal_page);
+          if (child != last) {
+            bpm_->PrefetchPage(internal_page->ValueAt(child));
+            last = child;
+            prefetched++;
+          }
+        }
+        leaf_separator = internal_page->KeyAt(i);
+        guard = bpm_->FetchPageRead(internal_page->ValueAt(i));
+      }
+      leaf_guard = std::move(guard);
+    }
+    const auto *leaf_page = leaf_guard.As<LeafPage>();
+    if (leaf_page->GetSize() == 0) {
+      continue;
+    }
+    int i = KeyIndex(key, leaf_page);
+    if (comparator_(leaf_page->KeyAt(i), key) == 0) {
+      (*results)[order[pos]].push_back(leaf_page->ValueAt(i));
+    }
+  }
+}
+
+/*****************************************************************************
+ * ROOT CACHE
+ *****************************************************************************/
+/*
+ * Readers go straight to the cached root instead of through the header page.
+ * Every write that holds the header write latched makes root_epoch_ odd before
+ * it touches the tree and even again once the root it leaves behind is cached,
+ * so a root read latched while the epoch stayed even and unchanged was the
+ * root all along, and can't be split or freed from under the latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRootRead(ReadPageGuard *header_guard) -> ReadPageGuard {
+  uint64_t epoch = root_epoch_.load();
+  if (epoch % 2 == 0) {
+    page_id_t root_page_id = cached_root_page_id_.load();
+    Page *root_frame = root_frame_.load();
+    ReadPageGuard guard;
+    if (root_page_id != INVALID_PAGE_ID && root_frame != nullptr) {
+      guard = bpm_->FetchPageReadInFrame(root_frame, root_page_id);
+    }
+    // The cached root is never fetched by id: without the header latched, it may be freed and its id handed out
+    // again before the epoch is checked, and fetching it would map a second frame for the new page. When the root
+    // has left its frame, the header is the way in.
+    if ((root_page_id == INVALID_PAGE_ID || guard.IsValid()) && root_epoch_.load() == epoch) {
+      return guard;
+    }
+  }
+
+  ReadPageGuard local_header_guard;
+  ReadPageGuard &header = header_guard != nullptr ? *header_guard : local_header_guard;
+  header = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = header.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return {};
+  }
+  return bpm_->FetchPageRead(root_page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BeginRootChange() { root_epoch_++; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::EndRootChange(page_id_t root_page_id) {
+  Page *root_frame = nullptr;
+  if (root_page_id != INVALID_PAGE_ID) {
+    // The header is still write latched, so this is the live root. Only remember where it is; the pin is dropped
+    // right away, so that the page can still be freed.
+    root_frame = bpm_->FetchPage(root_page_id);
+    if (root_frame != nullptr) {
+      bpm_->UnpinPage(root_page_id, false);
+    }
+  }
+  cached_root_page_id_ = root_page_id;
+  root_frame_ = root_frame;
+  root_epoch_++;
+}
+
+/*****************************************************************************
+ * OPTIMISTIC WRITES
+ *****************************************************************************/
+/*
+ * Inserts and removes that only touch one leaf don't need the header and the
+ * whole path write latched. They descend with read latches like GetValue, and
+ * fall back to the pessimistic path when a split, a merge or a separator change
+ * would be needed. A pessimistic writer has to write latch the parent before it
+ * can change a leaf's shape, and the optimistic writer holds that parent read
+ * latched until it owns the leaf, so the two never see each other half done.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key) -> std::optional<WritePageGuard> {
+  ReadPageGuard parent_guard;
+  ReadPageGuard guard = FetchRootRead(&parent_guard);
+  if (guard.IsValid() && !parent_guard.IsValid() && guard.As<BPlusTreePage>()->IsLeafPage()) {
+    // A root leaf is traded for a write latch with nothing held above it, so the header has to be.
+    guard.Drop();
+    parent_guard = bpm_->FetchPageRead(header_page_id_);
+    page_id_t root_page_id = parent_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (root_page_id != INVALID_PAGE_ID) {
+      guard = bpm_->FetchPageRead(root_page_id);
+    }
+  }
+  if (!guard.IsValid()) {
+    return std::nullopt;
+  }
+  while (true) {
+    page_id_t page_id = guard.PageId();
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard.Drop();
+      // parent_guard is released only after the write latch is taken.
+      return bpm_->FetchPageWrite(page_id);
+    }
+    auto *internal_page = guard.As<InternalPage>();
+    int i = KeyIndex(key, internal_page);
+    // key is beyond every separator, so the path's largest keys have to grow.
+    if (comparator_(internal_page->KeyAt(i), key) == -1) {
+      return std::nullopt;
+    }
+    page_id_t child_page_id = internal_page->ValueAt(i);
+    parent_guard = std::move(guard);
+    guard = bpm_->FetchPageRead(child_page_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool> {
+  std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key);
+  if (!leaf_guard.has_value()) {
+    return std::nullopt;
+  }
+  const auto *leaf_page = leaf_guard->As<LeafPage>();
+  int insert_pos = leaf_page->GetSize() != 0 ? KeyIndex(key, leaf_page) : 0;
+  if (leaf_page->GetSize() != 0 && comparator_(key, leaf_page->KeyAt(insert_pos)) == 0) {
+    return false;
+  }
+  // The leaf splits once it reaches its max size.
+  if (leaf_page->GetSize() + 1 >= leaf_page->GetMaxSize()) {
+    return std::nullopt;
+  }
+  if (leaf_page->GetSize() != 0 && comparator_(key, leaf_page->KeyAt(insert_pos)) == 1) {
+    insert_pos = leaf_page->GetSize();
+  }
+  InsertKey(key, value, leaf_guard->AsMut<LeafPage>(), insert_pos);
+  ++kv_num_;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveOptimistic(const KeyType &key) -> bool {
+  std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key);
+  if (!leaf_guard.has_value()) {
+    return false;
+  }
+  const auto *leaf_page = leaf_guard->As<LeafPage>();
+  if (leaf_page->GetSize() == 0) {
+    return false;
+  }
+  int dele_pos = KeyIndex(key, leaf_page);
+  if (comparator_(leaf_page->KeyAt(dele_pos), key) != 0) {
+    return true;
+  }
+  // Removing the largest key changes the separator in the parent, going below min size needs a merge, and an empty
+  // leaf has to be unlinked.
+  if (dele_pos == leaf_page->GetSize() - 1 ||
+      leaf_page->GetSize() - 1 < std::max(RemoveMinSize(leaf_page), 1)) {
+    return false;
+  }
+  DeleteKey(key, leaf_guard->AsMut<LeafPage>());
+  if (leaf_page->GetSize() < leaf_page->GetMinSize()) {
+    compaction_pending_ = true;
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveMinSize(const BPlusTreePage *page) const -> int {
+  return lazy_delete_ ? std::min(lazy_delete_min_size_.load(), page->GetMinSize()) : page->GetMinSize();
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -349,9 +609,15 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   // Declaration of context instance.
   // LOG_INFO("inserted size:%d\n", ++kv_num_);
   // LOG_INFO("inserted size:%d, key : %ld \n", ++kv_num_, key.ToString());
+  // Most inserts land in a leaf with room to spare, try those with only the leaf write latched first.
+  if (auto result = InsertOptimistic(key, value); result.has_value()) {
+    return *result;
+  }
+
   Context ctx;
   ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
   auto *header_page = ctx.header_page_->AsMut<BPlusTreeHeaderPage>();
+  RootChange root_change(this, header_page);
 
   // insert_set_latch_.WLock();
   // insert_set_.insert(key.ToString());
@@ -419,7 +685,9 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   SplitNode(leaf_page, tmp_leaf_page);
 
   tmp_leaf_page->SetNextPageId(leaf_page->GetNextPageId());
+  tmp_leaf_page->SetPrevPageId(child1);
   leaf_page->SetNextPageId(child2);
+  SetLeafPrevPageId(tmp_leaf_page->GetNextPageId(), child2);
 
   child1_key = leaf_page->KeyAt(leaf_page->GetSize() - 1);
   child2_key = tmp_leaf_page->KeyAt(tmp_leaf_page->GetSize() - 1);
@@ -466,6 +734,96 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   return true;
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+namespace {
+
+/**
+ * Split count entries into pages holding at most capacity entries each, filling pages to fill_factor. The entries are
+ * spread evenly, so the last page isn't left with a handful of them.
+ */
+auto PackPageSizes(size_t count, int capacity, double fill_factor, int min_per_page) -> std::vector<size_t> {
+  int per_page = static_cast<int>(capacity * fill_factor);
+  per_page = std::max(std::min(per_page, capacity), std::min(min_per_page, capacity));
+  size_t num_pages = (count + per_page - 1) / per_page;
+  std::vector<size_t> sizes(num_pages, count / num_pages);
+  for (size_t i = 0; i < count % num_pages; i++) {
+    sizes[i]++;
+  }
+  return sizes;
+}
+
+}  // namespace
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor) -> bool {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto *header_page = header_guard.AsMut<BPlusTreeHeaderPage>();
+  if (header_page->root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  RootChange root_change(this, header_page);
+
+  // Stable, so that of equal keys the first one wins, as it would with one Insert after another.
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) == -1; });
+  entries->erase(std::unique(entries->begin(), entries->end(),
+                             [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) == 0; }),
+                 entries->end());
+  if (entries->empty()) {
+    return true;
+  }
+
+  // The largest key and the page id of every page of the level built last.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+
+  // A leaf splits once it reaches its max size, so it holds at most max size - 1 entries.
+  size_t pos = 0;
+  WritePageGuard prev_leaf_guard;
+  for (size_t size : PackPageSizes(entries->size(), leaf_max_size_ - 1, fill_factor, 1)) {
+    page_id_t leaf_page_id;
+    WritePageGuard leaf_guard = bpm_->NewPageWrite(&leaf_page_id);
+    auto *leaf_page = leaf_guard.AsMut<LeafPage>();
+    leaf_page->Init(leaf_max_size_);
+    for (size_t i = 0; i < size; i++, pos++) {
+      leaf_page->SetKeyAt(i, (*entries)[pos].first);
+      leaf_page->SetValueAt(i, (*entries)[pos].second);
+    }
+    leaf_page->SetSize(size);
+    if (prev_leaf_guard.IsValid()) {
+      prev_leaf_guard.AsMut<LeafPage>()->SetNextPageId(leaf_page_id);
+      leaf_page->SetPrevPageId(prev_leaf_guard.PageId());
+    }
+    level.emplace_back(leaf_page->KeyAt(size - 1), leaf_page_id);
+    prev_leaf_guard = std::move(leaf_guard);
+  }
+  prev_leaf_guard.Drop();
+
+  // Every internal page needs at least two children, or the levels would never narrow down to a root.
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parent_level;
+    pos = 0;
+    for (size_t size : PackPageSizes(level.size(), internal_max_size_, fill_factor, 2)) {
+      page_id_t internal_page_id;
+      WritePageGuard internal_guard = bpm_->NewPageWrite(&internal_page_id);
+      auto *internal_page = internal_guard.AsMut<InternalPage>();
+      internal_page->Init(internal_max_size_);
+      for (size_t i = 0; i < size; i++, pos++) {
+        internal_page->SetKeyAt(i, level[pos].first);
+        internal_page->SetValueAt(i, level[pos].second);
+      }
+      internal_page->SetSize(size);
+      parent_level.emplace_back(internal_page->KeyAt(size - 1), internal_page_id);
+    }
+    level = std::move(parent_level);
+  }
+
+  header_page->root_page_id_ = level[0].second;
+  kv_num_ += entries->size();
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -479,10 +837,14 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
   // Declaration of context instance.
+  if (RemoveOptimistic(key)) {
+    return;
+  }
 
   Context ctx;
   ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
   auto *header_page = ctx.header_page_->AsMut<BPlusTreeHeaderPage>();
+  RootChange root_change(this, header_page);
   // del_set_latch_.WLock();
   // del_set_.insert(key.ToString());
   // del_set_latch_.WUnlock();
@@ -516,6 +878,24 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
   // newpage.Drop();
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Update(const KeyType &key, const ValueType &value) -> bool {
+  std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key);
+  if (!leaf_guard.has_value()) {
+    return false;
+  }
+  auto *leaf_page = leaf_guard->AsMut<LeafPage>();
+  if (leaf_page->GetSize() == 0) {
+    return false;
+  }
+  int pos = KeyIndex(key, leaf_page);
+  if (comparator_(leaf_page->KeyAt(pos), key) != 0) {
+    return false;
+  }
+  leaf_page->SetValueAt(pos, value);
+  return true;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn, page_id_t &pid,
                                             page_id_t &leftestchild, bool &needlookup) -> bool {
@@ -528,6 +908,7 @@ auto BPLUSTREE_TYPE::RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn
     }
     if (leaf_page->GetSize() == 0) {
       leftestchild = leaf_page->GetNextPageId();
+      SetLeafPrevPageId(leaf_page->GetNextPageId(), leaf_page->GetPrevPageId());
       pg_guard.Drop();
       bpm_->DeletePage(pid);
       pid = INVALID_PAGE_ID;
@@ -578,7 +959,9 @@ auto BPLUSTREE_TYPE::RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn
       bpm_->DeletePage(pid);
       pid = INVALID_PAGE_ID;
       if (is_nextlayer_child) {
+        // The removed leaf was the only child, so the leaf left of this page has to link to the leaf after it.
         needlookup = true;
+        leftestchild = m_leftestchild;
       }
       return true;
     }
@@ -616,7 +999,10 @@ auto BPLUSTREE_TYPE::RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn
     // 因为可能删除掉的可能是子节点中最大的值，因此需要修改对应的key
     internal_page->SetKeyAt(dele_pos, child_leaf_page->KeyAt(child_leaf_page->GetSize() - 1));
 
-    if (child_leaf_page->GetSize() >= child_leaf_page->GetMinSize()) {
+    if (child_leaf_page->GetSize() >= RemoveMinSize(child_leaf_page)) {
+      if (child_leaf_page->GetSize() < child_leaf_page->GetMinSize()) {
+        compaction_pending_ = true;
+      }
       return true;
     }
 
@@ -642,7 +1028,10 @@ auto BPLUSTREE_TYPE::RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn
   // 因为可能删除掉的可能是子节点中最大的值，因此需要修改对应的key
   internal_page->SetKeyAt(dele_pos, child_leaf_page->KeyAt(child_leaf_page->GetSize() - 1));
 
-  if (child_leaf_page->GetSize() >= child_leaf_page->GetMinSize()) {
+  if (child_leaf_page->GetSize() >= RemoveMinSize(child_leaf_page)) {
+    if (child_leaf_page->GetSize() < child_leaf_page->GetMinSize()) {
+      compaction_pending_ = true;
+    }
     return true;
   }
   if (internal_page->GetSize() == 1) {
@@ -668,6 +1057,127 @@ auto BPLUSTREE_TYPE::RemoveNodeWithoutMerge(const KeyType &key, Transaction *txn
   return true;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetLazyDelete(bool lazy, int min_size) {
+  BUSTUB_ENSURE(min_size >= 0, "invalid lazy delete min size");
+  lazy_delete_min_size_ = min_size;
+  lazy_delete_ = lazy;
+}
+
+/*****************************************************************************
+ * COMPACTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Compact() -> int {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto *header_page = header_guard.AsMut<BPlusTreeHeaderPage>();
+  compaction_pending_ = false;
+  if (header_page->root_page_id_ == INVALID_PAGE_ID) {
+    return 0;
+  }
+  RootChange root_change(this, header_page);
+  int freed = 0;
+  {
+    WritePageGuard root_guard = bpm_->FetchPageWrite(header_page->root_page_id_);
+    if (!root_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      freed += CompactNode(&root_guard);
+    }
+  }
+  // Lazy removes can leave a chain of single child pages on top of the tree.
+  while (true) {
+    page_id_t root_page_id = header_page->root_page_id_;
+    WritePageGuard root_guard = bpm_->FetchPageWrite(root_page_id);
+    const auto *root_page = root_guard.As<BPlusTreePage>();
+    if (root_page->IsLeafPage() || root_page->GetSize() > 1) {
+      break;
+    }
+    header_page->root_page_id_ = root_guard.As<InternalPage>()->ValueAt(0);
+    root_guard.Drop();
+    bpm_->DeletePage(root_page_id);
+    freed++;
+  }
+  return freed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::CompactNode(WritePageGuard *guard) -> int {
+  auto *page = guard->AsMut<InternalPage>();
+  int freed = 0;
+  // Bottom up, so that the children are final when they are merged. Two merged internal pages may leave two
+  // underfull pages side by side below them, which the next pass picks up.
+  for (int i = 0; i < page->GetSize(); i++) {
+    WritePageGuard child_guard = bpm_->FetchPageWrite(page->ValueAt(i));
+    if (!child_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      freed += CompactNode(&child_guard);
+    }
+  }
+  for (int i = 0; i < page->GetSize() && page->GetSize() > 1; i++) {
+    WritePageGuard child_guard = bpm_->FetchPageWrite(page->ValueAt(i));
+    auto *child = child_guard.AsMut<BPlusTreePage>();
+    // MergeNode refills the child from a sibling one entry at a time, or merges it with one.
+    while (child->GetSize() < child->GetMinSize() && page->GetSize() > 1) {
+      int old_size = page->GetSize();
+      if (child->IsLeafPage()) {
+        MergeNode(page, child_guard.AsMut<LeafPage>());
+      } else {
+        MergeNode(page, child_guard.AsMut<InternalPage>());
+      }
+      if (child->GetSize() == 0) {
+        // Merged into its left sibling, which is now at i - 1 and may still be underfull.
+        page_id_t drop = child_guard.PageId();
+        child_guard.Drop();
+        bpm_->DeletePage(drop);
+        freed++;
+        i -= 2;
+        break;
+      }
+      if (page->GetSize() < old_size) {
+        freed++;
+      }
+    }
+  }
+  return freed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartBackgroundCompaction() {
+  StopBackgroundCompaction();
+  enable_background_compaction_ = true;
+  background_compaction_thread_ = new std::thread(&BPLUSTREE_TYPE::RunBackgroundCompaction, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopBackgroundCompaction() {
+  if (background_compaction_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::scoped_lock lock(background_compaction_latch_);
+    enable_background_compaction_ = false;
+  }
+  background_compaction_cv_.notify_one();
+  background_compaction_thread_->join();
+  delete background_compaction_thread_;
+  background_compaction_thread_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RunBackgroundCompaction() {
+  while (enable_background_compaction_) {
+    {
+      std::unique_lock lock(background_compaction_latch_);
+      background_compaction_cv_.wait_for(lock, bplustree_compaction_interval,
+                                         [&] { return !enable_background_compaction_; });
+    }
+    if (!enable_background_compaction_) {
+      break;
+    }
+    if (compaction_pending_) {
+      Compact();
+    }
+  }
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -683,8 +1193,10 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
     return INDEXITERATOR_TYPE();
   }
 
-  ReadPageGuard iter_pageguard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = iter_pageguard.As<BPlusTreeHeaderPage>();
+  ReadPageGuard iter_pageguard = FetchRootRead();
+  if (!iter_pageguard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
   // LOG_INFO("tree size : %d, leaf_size : %d, internal_size : %d\n", (int)kv_num_, this->leaf_max_size_,
   // this->internal_max_size_); std::string log_info = "insert set : "; insert_set_latch_.RLock(); for (auto iter :
   // insert_set_) {
@@ -704,7 +1216,6 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
   // //LOG_INFO("%s", log_info.c_str());
   // del_set_latch_.RUnlock();
 
-  iter_pageguard = bpm_->FetchPageRead(root_page->root_page_id_);
   auto iter_page = iter_pageguard.As<BPlusTreePage>();
 
   while (!iter_page->IsLeafPage()) {
@@ -715,7 +1226,7 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
   }
   // auto leaf_page = iter_pageguard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
   //  LOG_INFO("Get Iterator Begin\n");
-  return INDEXITERATOR_TYPE(iter_pageguard.PageId(), bpm_, 0);
+  return INDEXITERATOR_TYPE(this, bpm_, std::move(iter_pageguard), 0, comparator_);
 }
 
 /*
@@ -732,7 +1243,10 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
 
   // Declaration of context instance.
   // Context ctx;
-  ReadPageGuard iter_pageguard = bpm_->FetchPageRead(header_page_id_);
+  ReadPageGuard iter_pageguard = FetchRootRead();
+  if (!iter_pageguard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
 
   // std::string log_info = "insert set : ";
   // insert_set_latch_.RLock();
@@ -753,9 +1267,6 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   // LOG_INFO("%s", log_info.c_str());
   // del_set_latch_.RUnlock();
 
-  auto root_page = iter_pageguard.As<BPlusTreeHeaderPage>();
-
-  iter_pageguard = bpm_->FetchPageRead(root_page->root_page_id_);
   auto iter_page = iter_pageguard.As<BPlusTreePage>();
 
   while (!iter_page->IsLeafPage()) {
@@ -778,12 +1289,59 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   int i = this->KeyIndex(key, leaf_page);
   if (comparator_(leaf_page->KeyAt(i), key) == 0) {
     // LOG_INFO("Get Iterator key : %ld\n", key.ToString());
-    return INDEXITERATOR_TYPE(iter_pageguard.PageId(), bpm_, i);
+    return INDEXITERATOR_TYPE(this, bpm_, std::move(iter_pageguard), i, comparator_);
   }
   BUSTUB_ASSERT(false, "Key None!\n");
   return INDEXITERATOR_TYPE();
 }
 
+/*
+ * Find the first key in the range (the last one, if reverse) and construct a
+ * bounded index iterator there, which ends once it leaves the range
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Range(std::optional<IndexKeyBound<KeyType>> lower, std::optional<IndexKeyBound<KeyType>> upper,
+                           bool reverse) -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard = FetchRootRead();
+  if (!guard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
+  const auto &start = reverse ? upper : lower;
+
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    const auto *internal_page = guard.As<InternalPage>();
+    int i;
+    if (start.has_value()) {
+      i = KeyIndex(start->key_, internal_page);
+    } else {
+      i = reverse ? internal_page->GetSize() - 1 : 0;
+    }
+    guard = bpm_->FetchPageRead(internal_page->ValueAt(i));
+  }
+  const auto *leaf_page = guard.As<LeafPage>();
+
+  int ind;
+  if (!start.has_value()) {
+    ind = reverse ? leaf_page->GetSize() - 1 : 0;
+  } else {
+    // The first key not less than the start key; KeyIndex stops at the last key even if that is smaller.
+    ind = leaf_page->GetSize() == 0 ? 0 : KeyIndex(start->key_, leaf_page);
+    if (ind < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(ind), start->key_) == -1) {
+      ind = leaf_page->GetSize();
+    }
+    bool on_start = ind < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(ind), start->key_) == 0;
+    if (reverse && !(on_start && start->inclusive_)) {
+      ind--;
+    } else if (!reverse && on_start && !start->inclusive_) {
+      ind++;
+    }
+  }
+
+  // The start may lie just past either end of the leaf, then the iterator moves on to the neighbouring one.
+  return INDEXITERATOR_TYPE(this, bpm_, std::move(guard), ind, comparator_, std::move(lower), std::move(upper));
+}
+
 /*
  * Input parameter is void, construct an index iterator representing the end
  * of the key/value pair in the leaf node
@@ -794,15 +1352,15 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
   if (IsEmpty()) {
     return INDEXITERATOR_TYPE();
   }
-  ReadPageGuard iter_pageguard = bpm_->FetchPageRead(header_page_id_);
+  ReadPageGuard iter_pageguard = FetchRootRead();
+  if (!iter_pageguard.IsValid()) {
+    return INDEXITERATOR_TYPE();
+  }
   // if (end_ != INVALID_PAGE_ID) {
   //   iter_pageguard = bpm_->FetchPageRead(header_page_id_);
   //   return INDEXITERATOR_TYPE(end_, bpm_, leaf_page->GetSize());
   // }
   // ReadPageGuard iter_pageguard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = iter_pageguard.As<BPlusTreeHeaderPage>();
-
-  iter_pageguard = bpm_->FetchPageRead(root_page->root_page_id_);
   auto iter_page = iter_pageguard.As<BPlusTreePage>();
 
   while (!iter_page->IsLeafPage()) {
@@ -813,7 +1371,8 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
   }
   auto leaf_page = iter_pageguard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
   // LOG_INFO("Get End Iterator pid : %d, ind_ : %d", iter_pageguard.PageId(), leaf_page->GetSize());
-  return INDEXITERATOR_TYPE(iter_pageguard.PageId(), bpm_, leaf_page->GetSize());
+  int size = leaf_page->GetSize();
+  return INDEXITERATOR_TYPE(this, bpm_, std::move(iter_pageguard), size, comparator_);
 }
 
 /**
@@ -821,6 +1380,13 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetRootPageId() const -> page_id_t {
+  uint64_t epoch = root_epoch_.load();
+  if (epoch % 2 == 0) {
+    page_id_t root_page_id = cached_root_page_id_.load();
+    if (root_epoch_.load() == epoch) {
+      return root_page_id;
+    }
+  }
   auto headerpage = bpm_->FetchPageRead(header_page_id_);
   const auto *header = headerpage.As<BPlusTreeHeaderPage>();
   return header->root_page_id_;
@@ -843,8 +1409,8 @@ void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *t
 
     KeyType index_key;
     index_key.SetFromInteger(key);
-    RID rid(key);
-    Insert(index_key, rid, txn);
+    ValueType value{RID(key)};
+    Insert(index_key, value, txn);
   }
 }
 /*
@@ -1055,6 +1621,12 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 
+template class BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class BPlusTree<GenericKey<8>, PostingList, GenericIntegerComparator<8>>;
+
+template class BPlusTree<GenericKey<16>, RID, GenericIntegerComparator<16>>;
+
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
@@ -7,8 +7,10 @@
 #include "common/config.h"
 #include "common/logger.h"
 #include "common/macros.h"
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/posting_list_page.h"
 
 namespace bustub {
 
@@ -17,63 +19,221 @@ namespace bustub {
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(page_id_t pid, BufferPoolManager *bpm, int ind) : bpm_(bpm), pid_(pid), ind_(ind) {
-  // leaf_pg_guard_ = bpm_->FetchPageRead(pid);
-  // pg_pointer_ = leaf_pg_guard_.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
-  // ind_ = 0;
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, BufferPoolManager *bpm,
+                                  ReadPageGuard leaf_guard, int ind, const KeyComparator &comparator,
+                                  std::optional<IndexKeyBound<KeyType>> lower,
+                                  std::optional<IndexKeyBound<KeyType>> upper)
+    : tree_(tree),
+      bpm_(bpm),
+      pid_(leaf_guard.PageId()),
+      ind_(ind),
+      prefetcher_(bpm, SCAN_READAHEAD_DEPTH,
+                  [](const char *page_data) {
+                    const auto *page = reinterpret_cast<const BPlusTreePage *>(page_data);
+                    // The leaf may have been merged away and its page reused since we fetched it.
+                    if (!page->IsLeafPage()) {
+                      return INVALID_PAGE_ID;
+                    }
+                    return reinterpret_cast<const LeafPage *>(page)->GetNextPageId();
+                  }),
+      prev_prefetcher_(bpm, SCAN_READAHEAD_DEPTH,
+                       [](const char *page_data) {
+                         const auto *page = reinterpret_cast<const BPlusTreePage *>(page_data);
+                         if (!page->IsLeafPage()) {
+                           return INVALID_PAGE_ID;
+                         }
+                         return reinterpret_cast<const LeafPage *>(page)->GetPrevPageId();
+                       }),
+      comparator_(comparator),
+      lower_(std::move(lower)),
+      upper_(std::move(upper)) {
+  CopyLeaf(pid_, leaf_guard.As<LeafPage>());
+  leaf_guard.Drop();
+  if (ind_ < 0) {
+    PrevLeaf();
+  } else if (ind_ >= static_cast<int>(entries_.size())) {
+    NextLeaf();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::CopyLeaf(page_id_t page_id, const LeafPage *leaf) {
+  pid_ = page_id;
+  entries_.clear();
+  entries_.reserve(leaf->GetSize());
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    entries_.push_back(leaf->ArrayAt(i));
+  }
+  next_page_id_ = leaf->GetNextPageId();
+  prev_page_id_ = leaf->GetPrevPageId();
 }
 
-// INDEX_TEMPLATE_ARGUMENTS
-// INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::NextLeaf() {
+  if (ind_ < static_cast<int>(entries_.size()) || next_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  // Only the root leaf can start out empty, and it has no neighbours.
+  BUSTUB_ASSERT(!entries_.empty(), "empty leaf in a chain");
+  KeyType last_key = entries_.back().first;
+  while (ind_ >= static_cast<int>(entries_.size()) && next_page_id_ != INVALID_PAGE_ID) {
+    page_id_t from_page_id = pid_;
+    page_id_t page_id = next_page_id_;
+
+    // Latch one leaf at a time: writers latch siblings right to left when merging, so holding this leaf while
+    // latching the next one could deadlock with them.
+    std::optional<INDEXITERATOR_TYPE> next;
+    {
+      ReadPageGuard guard = bpm_->FetchPageRead(page_id, AccessType::Scan);
+      const auto *leaf = guard.As<LeafPage>();
+      if (leaf->IsLeafPage() && leaf->GetPrevPageId() == from_page_id &&
+          (leaf->GetSize() == 0 || (*comparator_)(leaf->KeyAt(0), last_key) > 0)) {
+        next.emplace();
+        next->CopyLeaf(page_id, leaf);
+      }
+    }
+    bool valid = next.has_value();
+    if (valid) {
+      // Keys move between neighbours without changing the links, but then the last key of this leaf changes.
+      ReadPageGuard guard = bpm_->FetchPageRead(from_page_id, AccessType::Scan);
+      const auto *leaf = guard.As<LeafPage>();
+      valid = leaf->IsLeafPage() && leaf->GetNextPageId() == page_id && leaf->GetSize() > 0 &&
+              (*comparator_)(leaf->KeyAt(leaf->GetSize() - 1), last_key) == 0;
+    }
+    if (!valid) {
+      // Started below the range (see BPlusTree::Range), the keys up to the lower bound still need skipping.
+      IndexKeyBound<KeyType> from{last_key, false};
+      if (lower_.has_value() && (*comparator_)(lower_->key_, last_key) > 0) {
+        from = *lower_;
+      }
+      Resume(tree_->Range(from, upper_));
+      return;
+    }
+    entries_ = std::move(next->entries_);
+    pid_ = page_id;
+    next_page_id_ = next->next_page_id_;
+    prev_page_id_ = next->prev_page_id_;
+    ind_ = 0;
+    if (!entries_.empty()) {
+      last_key = entries_.back().first;
+    }
+    prefetcher_.Advance(pid_);
+  }
+}
 
-// INDEX_TEMPLATE_ARGUMENTS
-// INDEXITERATOR_TYPE::IndexIterator() = default;
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::PrevLeaf() {
+  std::optional<KeyType> first_key;
+  while (ind_ < 0) {
+    if (prev_page_id_ == INVALID_PAGE_ID) {
+      // Stepped back past the first key: leave the chain, which IsEnd reports as the end.
+      pid_ = INVALID_PAGE_ID;
+      ind_ = 0;
+      entries_.clear();
+      return;
+    }
+    if (!entries_.empty()) {
+      first_key = entries_.front().first;
+    }
+    BUSTUB_ASSERT(first_key.has_value(), "empty leaf in a chain");
+    page_id_t from_page_id = pid_;
+    page_id_t page_id = prev_page_id_;
+
+    std::optional<INDEXITERATOR_TYPE> prev;
+    {
+      ReadPageGuard guard = bpm_->FetchPageRead(page_id, AccessType::Scan);
+      const auto *leaf = guard.As<LeafPage>();
+      if (leaf->IsLeafPage() && leaf->GetNextPageId() == from_page_id &&
+          (leaf->GetSize() == 0 || (*comparator_)(leaf->KeyAt(leaf->GetSize() - 1), *first_key) < 0)) {
+        prev.emplace();
+        prev->CopyLeaf(page_id, leaf);
+      }
+    }
+    bool valid = prev.has_value();
+    if (valid) {
+      ReadPageGuard guard = bpm_->FetchPageRead(from_page_id, AccessType::Scan);
+      const auto *leaf = guard.As<LeafPage>();
+      valid = leaf->IsLeafPage() && leaf->GetPrevPageId() == page_id && leaf->GetSize() > 0 &&
+              (*comparator_)(leaf->KeyAt(0), *first_key) == 0;
+    }
+    if (!valid) {
+      IndexKeyBound<KeyType> from{*first_key, false};
+      if (upper_.has_value() && (*comparator_)(upper_->key_, *first_key) < 0) {
+        from = *upper_;
+      }
+      Resume(tree_->Range(lower_, from, true));
+      return;
+    }
+    entries_ = std::move(prev->entries_);
+    pid_ = page_id;
+    next_page_id_ = prev->next_page_id_;
+    prev_page_id_ = prev->prev_page_id_;
+    ind_ = static_cast<int>(entries_.size()) - 1;
+    prev_prefetcher_.Advance(pid_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Resume(INDEXITERATOR_TYPE &&resumed) {
+  // The bounds of this iterator stay: the resumed one only narrowed them to the keys not returned yet.
+  pid_ = resumed.pid_;
+  ind_ = resumed.ind_;
+  entries_ = std::move(resumed.entries_);
+  next_page_id_ = resumed.next_page_id_;
+  prev_page_id_ = resumed.prev_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::InRange(const KeyType &key) const -> bool {
+  if (lower_.has_value()) {
+    int cmp = (*comparator_)(key, lower_->key_);
+    if (cmp < 0 || (cmp == 0 && !lower_->inclusive_)) {
+      return false;
+    }
+  }
+  if (upper_.has_value()) {
+    int cmp = (*comparator_)(key, upper_->key_);
+    if (cmp > 0 || (cmp == 0 && !upper_->inclusive_)) {
+      return false;
+    }
+  }
+  return true;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() const -> bool {
-  // return pg_pointer_->GetNextPageId() == INVALID_PAGE_ID && ind_ == pg_pointer_->GetSize();
-  // return ind_ == pg_pointer_->GetSize();
-  if (IsEmpty()) {
+  if (IsEmpty() || ind_ >= static_cast<int>(entries_.size())) {
     return true;
   }
-  ReadPageGuard pg_guard = bpm_->FetchPageRead(pid_);
-  const auto *pg_pointer = pg_guard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
-  return IsEndP(pg_pointer);
+  return !InRange(entries_[ind_].first);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-  if (IsEmpty()) {
-    BUSTUB_ASSERT(false, "*END\n");
-  }
-  ReadPageGuard pg_guard = bpm_->FetchPageRead(pid_);
-  const auto *pg_pointer = pg_guard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
-  if (IsEndP(pg_pointer)) {
+  if (IsEmpty() || ind_ >= static_cast<int>(entries_.size())) {
     LOG_ERROR("*END ITERATOR pid : %d, ind_ : %d", pid_, ind_);
     BUSTUB_ASSERT(false, "*END\n");
   }
-  return pg_pointer->ArrayAt(ind_);
+  return entries_[ind_];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  if (IsEmpty()) {
-    BUSTUB_ASSERT(false, "++END\n");
-  }
-  ReadPageGuard pg_guard = bpm_->FetchPageRead(pid_);
-  const auto *pg_pointer = pg_guard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
-  if (IsEndP(pg_pointer)) {
+  if (IsEmpty() || ind_ >= static_cast<int>(entries_.size())) {
     BUSTUB_ASSERT(false, "++END\n");
   }
   ind_++;
-  if (ind_ < pg_pointer->GetSize() || pg_pointer->GetNextPageId() == INVALID_PAGE_ID) {
-    return *this;
-  }
+  NextLeaf();
+  return *this;
+}
 
-  ind_ = 0;
-  pid_ = pg_pointer->GetNextPageId();
-  // pg_guard = bpm_->FetchPageRead(newid);
-  // pg_pointer_ = pg_guard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator--() -> INDEXITERATOR_TYPE & {
+  if (IsEmpty()) {
+    BUSTUB_ASSERT(false, "--END\n");
+  }
+  ind_--;
+  PrevLeaf();
   return *this;
 }
 
@@ -83,6 +243,12 @@ template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
 
 template class IndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
 
+template class IndexIterator<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class IndexIterator<GenericKey<8>, PostingList, GenericIntegerComparator<8>>;
+
+template class IndexIterator<GenericKey<16>, RID, GenericIntegerComparator<16>>;
+
 template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// int_key_search.cpp
+//
+// Identification: src/storage/index/int_key_search.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/int_key_search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_HAS_X86_SIMD
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** Binary search stops once this many keys are left, and the rest are scanned linearly. */
+constexpr int LINEAR_SEARCH_WINDOW = 16;
+
+inline auto LoadKey(const char *base, size_t stride, int index, int shift) -> int64_t {
+  uint64_t word;
+  memcpy(&word, base + stride * index, sizeof(word));
+  return static_cast<int64_t>(word << shift);
+}
+
+auto LinearScalar(const char *base, size_t stride, int l, int r, int64_t key, int shift) -> int {
+  while (l < r && LoadKey(base, stride, l, shift) < key) {
+    l++;
+  }
+  return l;
+}
+
+#ifdef BUSTUB_HAS_X86_SIMD
+__attribute__((target("avx2"))) auto LinearAvx2(const char *base, size_t stride, int l, int r, int64_t key, int shift)
+    -> int {
+  const auto s = static_cast<int64_t>(stride);
+  const __m256i offsets = _mm256_set_epi64x(3 * s, 2 * s, s, 0);
+  const __m256i probe = _mm256_set1_epi64x(key);
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  for (; l + 4 <= r; l += 4) {
+    __m256i words =
+        _mm256_i64gather_epi64(reinterpret_cast<const long long *>(base + stride * l), offsets, 1);  // NOLINT
+    words = _mm256_sll_epi64(words, count);
+    // keys are sorted, so the lanes less than key are a prefix
+    auto less = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(probe, words))));
+    if (less != 0xf) {
+      return l + __builtin_popcount(less);
+    }
+  }
+  return LinearScalar(base, stride, l, r, key, shift);
+}
+
+__attribute__((target("sse4.2"))) auto LinearSse42(const char *base, size_t stride, int l, int r, int64_t key,
+                                                    int shift) -> int {
+  const __m128i probe = _mm_set1_epi64x(key);
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  for (; l + 2 <= r; l += 2) {
+    uint64_t lo;
+    uint64_t hi;
+    memcpy(&lo, base + stride * l, sizeof(lo));
+    memcpy(&hi, base + stride * (l + 1), sizeof(hi));
+    __m128i words = _mm_sll_epi64(_mm_set_epi64x(static_cast<int64_t>(hi), static_cast<int64_t>(lo)), count);
+    auto less = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(probe, words))));
+    if (less != 0x3) {
+      return l + __builtin_popcount(less);
+    }
+  }
+  return LinearScalar(base, stride, l, r, key, shift);
+}
+#endif
+
+using LinearSearchFn = auto (*)(const char *, size_t, int, int, int64_t, int) -> int;
+
+auto PickLinearSearch() -> LinearSearchFn {
+#ifdef BUSTUB_HAS_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return LinearAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return LinearSse42;
+  }
+#endif
+  return LinearScalar;
+}
+
+}  // namespace
+
+auto IntKeyLowerBound(const char *base, size_t stride, int n, int64_t key, int shift) -> int {
+  static const LinearSearchFn linear_search = PickLinearSearch();
+  int l = 0;
+  int r = n;
+  while (r - l > LINEAR_SEARCH_WINDOW) {
+    int mid = (l + r) >> 1;
+    if (LoadKey(base, stride, mid, shift) < key) {
+      l = mid + 1;
+    } else {
+      r = mid;
+    }
+  }
+  return linear_search(base, stride, l, r, key, shift);
+}
+
+}  // namespace bustub
@@ -0,0 +1,297 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/posting_b_plus_tree_index.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/posting_b_plus_tree_index.h"
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+auto RidLess(const RID &a, const RID &b) -> bool { return a.Get() < b.Get(); }
+
+}  // namespace
+
+BPlusTreePostingIndex::BPlusTreePostingIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                             BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()), bpm_(buffer_pool_manager) {
+  page_id_t header_page_id;
+  bpm_->NewPage(&header_page_id);
+  container_ = std::make_unique<PostingTree>(GetMetadata()->GetName(), header_page_id, bpm_, comparator_);
+  bpm_->UnpinPage(header_page_id, true);
+}
+
+auto BPlusTreePostingIndex::KeyLatch(const IntegerKeyType &key) -> std::shared_mutex & {
+  return key_latches_[hash_function_.GetHash(key) % KEY_LATCH_COUNT];
+}
+
+auto BPlusTreePostingIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  IntegerKeyType index_key;
+  index_key.SetFromKey(key);
+  std::unique_lock<std::shared_mutex> lock(KeyLatch(index_key));
+
+  std::vector<PostingList> lists;
+  if (!container_->GetValue(index_key, &lists)) {
+    return container_->Insert(index_key, PostingList(rid), transaction);
+  }
+  PostingList list = lists[0];
+  if (list.IsInline()) {
+    std::vector<RID> rids;
+    list.GetInline(&rids);
+    auto pos = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+    if (pos != rids.end() && *pos == rid) {
+      return false;
+    }
+    rids.insert(pos, rid);
+    if (!list.SetInline(rids)) {
+      list.SetOverflow(WriteOverflowPages(rids), rids.size());
+    }
+  } else if (!InsertOverflow(&list, rid)) {
+    return false;
+  }
+  // Only writers of this key change its value, and they wait for the latch we hold, so the key is still there.
+  container_->Update(index_key, list);
+  return true;
+}
+
+void BPlusTreePostingIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  IntegerKeyType index_key;
+  index_key.SetFromKey(key);
+  std::unique_lock<std::shared_mutex> lock(KeyLatch(index_key));
+
+  std::vector<PostingList> lists;
+  if (!container_->GetValue(index_key, &lists)) {
+    return;
+  }
+  PostingList list = lists[0];
+  if (list.IsInline()) {
+    std::vector<RID> rids;
+    list.GetInline(&rids);
+    auto pos = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+    if (pos == rids.end() || !(*pos == rid)) {
+      return;
+    }
+    rids.erase(pos);
+    list.SetInline(rids);
+  } else if (!RemoveOverflow(&list, rid)) {
+    return;
+  }
+  if (list.GetCount() == 0) {
+    container_->Remove(index_key, transaction);
+  } else {
+    container_->Update(index_key, list);
+  }
+}
+
+void BPlusTreePostingIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  IntegerKeyType index_key;
+  index_key.SetFromKey(key);
+  std::shared_lock<std::shared_mutex> lock(KeyLatch(index_key));
+
+  std::vector<PostingList> lists;
+  if (!container_->GetValue(index_key, &lists, transaction)) {
+    return;
+  }
+  if (lists[0].IsInline()) {
+    lists[0].GetInline(result);
+  } else {
+    ReadOverflowPages(lists[0].GetOverflowPageId(), result);
+  }
+}
+
+void BPlusTreePostingIndex::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                     Transaction *transaction) {
+  std::vector<IntegerKeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+  }
+  std::vector<std::vector<PostingList>> lists;
+  container_->GetValues(index_keys, &lists, transaction);
+
+  results->resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!lists[i].empty()) {
+      GetRids(index_keys[i], lists[i][0], &(*results)[i]);
+    }
+  }
+}
+
+auto BPlusTreePostingIndex::BulkLoad(std::vector<std::pair<IntegerKeyType, RID>> *entries) -> bool {
+  if (!container_->IsEmpty()) {
+    return false;
+  }
+  std::sort(entries->begin(), entries->end(), [this](const auto &a, const auto &b) {
+    int order = comparator_(a.first, b.first);
+    return order != 0 ? order < 0 : RidLess(a.second, b.second);
+  });
+
+  std::vector<std::pair<IntegerKeyType, PostingList>> lists;
+  std::vector<RID> rids;
+  for (size_t begin = 0, end; begin < entries->size(); begin = end) {
+    rids.clear();
+    for (end = begin; end < entries->size() && comparator_((*entries)[end].first, (*entries)[begin].first) == 0; end++) {
+      if (rids.empty() || !(rids.back() == (*entries)[end].second)) {
+        rids.push_back((*entries)[end].second);
+      }
+    }
+    PostingList list;
+    if (!list.SetInline(rids)) {
+      list.SetOverflow(WriteOverflowPages(rids), rids.size());
+    }
+    lists.emplace_back((*entries)[begin].first, list);
+  }
+  return container_->BulkLoad(&lists);
+}
+
+auto BPlusTreePostingIndex::GetRangeIterator(std::optional<IndexKeyBound<IntegerKeyType>> lower,
+                                             std::optional<IndexKeyBound<IntegerKeyType>> upper, bool reverse)
+    -> PostingIterator {
+  return container_->Range(std::move(lower), std::move(upper), reverse);
+}
+
+void BPlusTreePostingIndex::GetRids(const IntegerKeyType &key, const PostingList &list, std::vector<RID> *rids) {
+  if (list.IsInline()) {
+    list.GetInline(rids);
+    return;
+  }
+  std::shared_lock<std::shared_mutex> lock(KeyLatch(key));
+  std::vector<PostingList> lists;
+  if (!container_->GetValue(key, &lists)) {
+    return;
+  }
+  if (lists[0].IsInline()) {
+    lists[0].GetInline(rids);
+  } else {
+    ReadOverflowPages(lists[0].GetOverflowPageId(), rids);
+  }
+}
+
+auto BPlusTreePostingIndex::WriteOverflowPages(const std::vector<RID> &rids) -> page_id_t {
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  WritePageGuard prev_guard;
+  for (size_t begin = 0, end; begin < rids.size(); begin = end) {
+    end = RidDeltaCodec::FitCount(rids, begin, PostingListPage::Capacity());
+    page_id_t page_id;
+    WritePageGuard guard = bpm_->NewPageWrite(&page_id);
+    auto *page = guard.AsMut<PostingListPage>();
+    page->Init();
+    page->SetRids(rids, begin, end);
+    if (prev_guard.IsValid()) {
+      prev_guard.AsMut<PostingListPage>()->SetNextPageId(page_id);
+    } else {
+      first_page_id = page_id;
+    }
+    prev_guard = std::move(guard);
+  }
+  return first_page_id;
+}
+
+void BPlusTreePostingIndex::ReadOverflowPages(page_id_t page_id, std::vector<RID> *rids) {
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<PostingListPage>();
+    page->GetRids(rids);
+    page_id = page->GetNextPageId();
+  }
+}
+
+auto BPlusTreePostingIndex::InsertOverflow(PostingList *list, RID rid) -> bool {
+  // rid goes to the first page whose RIDs reach up to it, or else to the last page.
+  WritePageGuard guard = bpm_->FetchPageWrite(list->GetOverflowPageId());
+  while (guard.As<PostingListPage>()->GetNextPageId() != INVALID_PAGE_ID &&
+         guard.As<PostingListPage>()->GetLastRid().Get() < rid.Get()) {
+    guard = bpm_->FetchPageWrite(guard.As<PostingListPage>()->GetNextPageId());
+  }
+  auto *page = guard.AsMut<PostingListPage>();
+  std::vector<RID> rids;
+  page->GetRids(&rids);
+  auto pos = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (pos != rids.end() && *pos == rid) {
+    return false;
+  }
+  bool append = pos == rids.end() && page->GetNextPageId() == INVALID_PAGE_ID;
+  rids.insert(pos, rid);
+  if (!page->SetRids(rids, 0, rids.size())) {
+    // Split the page in half, except that a RID past the end of the list starts a new page of its own: RIDs of a table
+    // heap mostly come in rising order, and this leaves the pages behind full.
+    size_t split = append ? rids.size() - 1 : rids.size() / 2;
+    page_id_t new_page_id;
+    WritePageGuard new_guard = bpm_->NewPageWrite(&new_page_id);
+    auto *new_page = new_guard.AsMut<PostingListPage>();
+    new_page->Init();
+    BUSTUB_ENSURE(new_page->SetRids(rids, split, rids.size()), "half a posting list page must fit in a page");
+    new_page->SetNextPageId(page->GetNextPageId());
+    BUSTUB_ENSURE(page->SetRids(rids, 0, split), "half a posting list page must fit in a page");
+    page->SetNextPageId(new_page_id);
+  }
+  list->SetOverflow(list->GetOverflowPageId(), list->GetCount() + 1);
+  return true;
+}
+
+auto BPlusTreePostingIndex::RemoveOverflow(PostingList *list, RID rid) -> bool {
+  page_id_t first_page_id = list->GetOverflowPageId();
+  WritePageGuard prev_guard;
+  WritePageGuard guard = bpm_->FetchPageWrite(first_page_id);
+  while (guard.As<PostingListPage>()->GetNextPageId() != INVALID_PAGE_ID &&
+         guard.As<PostingListPage>()->GetLastRid().Get() < rid.Get()) {
+    page_id_t next_page_id = guard.As<PostingListPage>()->GetNextPageId();
+    prev_guard = std::move(guard);
+    guard = bpm_->FetchPageWrite(next_page_id);
+  }
+  auto *page = guard.AsMut<PostingListPage>();
+  std::vector<RID> rids;
+  page->GetRids(&rids);
+  auto pos = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (pos == rids.end() || !(*pos == rid)) {
+    return false;
+  }
+  rids.erase(pos);
+  if (rids.empty()) {
+    // Unlink the emptied page and give it back.
+    page_id_t page_id = guard.PageId();
+    if (prev_guard.IsValid()) {
+      prev_guard.AsMut<PostingListPage>()->SetNextPageId(page->GetNextPageId());
+    } else {
+      first_page_id = page->GetNextPageId();
+    }
+    guard.Drop();
+    bpm_->DeletePage(page_id);
+  } else {
+    page->SetRids(rids, 0, rids.size());
+    guard.Drop();
+  }
+  prev_guard.Drop();
+  list->SetOverflow(first_page_id, list->GetCount() - 1);
+  if (first_page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+
+  // A list down to one page that fits inline again goes back into the tree.
+  std::vector<RID> remaining;
+  {
+    ReadPageGuard first_guard = bpm_->FetchPageRead(first_page_id);
+    const auto *first_page = first_guard.As<PostingListPage>();
+    if (first_page->GetNextPageId() != INVALID_PAGE_ID || first_page->GetEncodedSize() > PostingList::INLINE_SIZE) {
+      return true;
+    }
+    first_page->GetRids(&remaining);
+  }
+  BUSTUB_ENSURE(list->SetInline(remaining), "a page that fits inline must fit inline");
+  bpm_->DeletePage(first_page_id);
+  return true;
+}
+
+}  // namespace bustub
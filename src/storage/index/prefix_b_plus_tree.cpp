@@ -0,0 +1,295 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefix_b_plus_tree.cpp
+//
+// Identification: src/storage/index/prefix_b_plus_tree.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/prefix_b_plus_tree.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * ITERATOR
+ *****************************************************************************/
+
+PrefixIndexIterator::PrefixIndexIterator(BufferPoolManager *bpm, page_id_t pid, int ind)
+    : bpm_(bpm), pid_(pid), ind_(ind) {
+  SkipExhaustedLeaves();
+}
+
+void PrefixIndexIterator::SkipExhaustedLeaves() {
+  while (pid_ != INVALID_PAGE_ID) {
+    ReadPageGuard guard = bpm_->FetchPageRead(pid_, AccessType::Scan);
+    const auto *leaf = guard.As<BPlusTreePrefixLeafPage>();
+    if (ind_ < leaf->GetSize()) {
+      return;
+    }
+    pid_ = leaf->GetNextPageId();
+    ind_ = 0;
+  }
+}
+
+auto PrefixIndexIterator::operator*() -> std::pair<std::string, RID> {
+  BUSTUB_ASSERT(!IsEnd(), "*END\n");
+  ReadPageGuard guard = bpm_->FetchPageRead(pid_, AccessType::Scan);
+  const auto *leaf = guard.As<BPlusTreePrefixLeafPage>();
+  return {leaf->KeyAt(ind_), leaf->ValueAt(ind_)};
+}
+
+auto PrefixIndexIterator::operator++() -> PrefixIndexIterator & {
+  BUSTUB_ASSERT(!IsEnd(), "++END\n");
+  ind_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+
+PrefixBPlusTree::PrefixBPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager)
+    : index_name_(std::move(name)), bpm_(buffer_pool_manager), header_page_id_(header_page_id) {
+  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+  guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = INVALID_PAGE_ID;
+}
+
+auto PrefixBPlusTree::MaxKeySize() -> size_t {
+  // Four maximal entries fit in a page, so a page that overflows by one entry can always be split in two.
+  return (bustub_page_size - BPlusTreePrefixPage::HEADER_SIZE) / 4 - BPlusTreePrefixPage::SLOT_SIZE;
+}
+
+auto PrefixBPlusTree::IsEmpty() const -> bool { return GetRootPageId() == INVALID_PAGE_ID; }
+
+auto PrefixBPlusTree::GetRootPageId() const -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
+
+auto PrefixBPlusTree::FindLeafRead(std::string_view key, bool leftmost) -> ReadPageGuard {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return {};
+  }
+  guard = bpm_->FetchPageRead(root_page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    const auto *internal = guard.As<InternalPage>();
+    guard = bpm_->FetchPageRead(internal->ValueAt(leftmost ? 0 : internal->ChildIndex(key)));
+  }
+  return guard;
+}
+
+auto PrefixBPlusTree::GetValue(std::string_view key, std::vector<RID> *result) -> bool {
+  ReadPageGuard guard = FindLeafRead(key, false);
+  if (!guard.IsValid()) {
+    return false;
+  }
+  const auto *leaf = guard.As<LeafPage>();
+  int i = leaf->KeyIndex(key);
+  if (i == leaf->GetSize() || leaf->KeyAt(i) != key) {
+    return false;
+  }
+  if (result != nullptr) {
+    result->push_back(leaf->ValueAt(i));
+  }
+  return true;
+}
+
+auto PrefixBPlusTree::GetHeight() -> int {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  int height = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    guard = bpm_->FetchPageRead(page_id);
+    height++;
+    page_id = guard.As<BPlusTreePage>()->IsLeafPage() ? INVALID_PAGE_ID : guard.As<InternalPage>()->ValueAt(0);
+  }
+  return height;
+}
+
+auto PrefixBPlusTree::ShortestSeparator(const std::string &lo, const std::string &hi) -> std::string {
+  size_t length = std::min(lo.size(), hi.size());
+  size_t diff = std::mismatch(lo.begin(), lo.begin() + length, hi.begin()).first - lo.begin();
+  // Either hi[diff] > lo[diff], or lo is a prefix of hi; in both cases hi's first diff + 1 bytes are > lo.
+  return hi.substr(0, diff + 1);
+}
+
+auto PrefixBPlusTree::SplitPoint(const std::vector<Entry> &entries, bool skip_first) -> size_t {
+  auto left_size = [&](size_t m) {
+    return BPlusTreePrefixPage::RequiredSize(std::vector<Entry>(entries.begin(), entries.begin() + m), skip_first);
+  };
+  auto right_size = [&](size_t m) {
+    return BPlusTreePrefixPage::RequiredSize(std::vector<Entry>(entries.begin() + m, entries.end()), skip_first);
+  };
+  auto fits = [&](size_t m) {
+    return left_size(m) <= static_cast<size_t>(bustub_page_size) &&
+           right_size(m) <= static_cast<size_t>(bustub_page_size);
+  };
+
+  // The left half only grows and the right half only shrinks as m moves right, so find where they cross.
+  size_t lo = 1;
+  size_t hi = entries.size() - 1;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (left_size(mid) < right_size(mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  auto imbalance = [&](size_t m) {
+    return std::abs(static_cast<int64_t>(left_size(m)) - static_cast<int64_t>(right_size(m)));
+  };
+  if (lo > 1 && fits(lo - 1) && (!fits(lo) || imbalance(lo - 1) < imbalance(lo))) {
+    return lo - 1;
+  }
+  if (fits(lo)) {
+    return lo;
+  }
+  // The balanced split can fail when a new key at either end shrank the common prefix; isolating that key works.
+  return fits(1) ? 1 : entries.size() - 1;
+}
+
+auto PrefixBPlusTree::Insert(std::string_view key, RID value) -> bool {
+  if (key.size() > MaxKeySize()) {
+    return false;
+  }
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto *header = header_guard.AsMut<BPlusTreeHeaderPage>();
+  if (header->root_page_id_ == INVALID_PAGE_ID) {
+    WritePageGuard root_guard = bpm_->NewPageWrite(&header->root_page_id_);
+    auto *root = root_guard.AsMut<LeafPage>();
+    root->Init();
+    root->Build({LeafPage::MakeEntry(std::string(key), value)});
+    return true;
+  }
+
+  std::vector<WritePageGuard> path;
+  path.push_back(bpm_->FetchPageWrite(header->root_page_id_));
+  while (!path.back().As<BPlusTreePage>()->IsLeafPage()) {
+    const auto *internal = path.back().As<InternalPage>();
+    path.push_back(bpm_->FetchPageWrite(internal->ValueAt(internal->ChildIndex(key))));
+  }
+
+  auto *leaf = path.back().AsMut<LeafPage>();
+  int pos = leaf->KeyIndex(key);
+  if (pos < leaf->GetSize() && leaf->KeyAt(pos) == key) {
+    return false;
+  }
+  std::vector<Entry> entries = leaf->Entries();
+  entries.insert(entries.begin() + pos, LeafPage::MakeEntry(std::string(key), value));
+  if (LeafPage::Fits(entries)) {
+    leaf->Build(entries);
+    return true;
+  }
+
+  size_t split = SplitPoint(entries, false);
+  std::vector<Entry> right_entries(entries.begin() + split, entries.end());
+  entries.resize(split);
+  page_id_t right_page_id;
+  WritePageGuard right_guard = bpm_->NewPageWrite(&right_page_id);
+  auto *right = right_guard.AsMut<LeafPage>();
+  right->Init();
+  right->Build(right_entries);
+  right->SetNextPageId(leaf->GetNextPageId());
+  leaf->Build(entries);
+  leaf->SetNextPageId(right_page_id);
+  right_guard.Drop();
+
+  InsertIntoParent(&path, header, ShortestSeparator(entries.back().first, right_entries.front().first),
+                   right_page_id);
+  return true;
+}
+
+void PrefixBPlusTree::InsertIntoParent(std::vector<WritePageGuard> *path, BPlusTreeHeaderPage *header,
+                                       std::string separator, page_id_t right_page_id) {
+  while (true) {
+    page_id_t left_page_id = path->back().PageId();
+    path->pop_back();
+    if (path->empty()) {
+      WritePageGuard root_guard = bpm_->NewPageWrite(&header->root_page_id_);
+      auto *root = root_guard.AsMut<InternalPage>();
+      root->Init();
+      root->Build({InternalPage::MakeEntry("", left_page_id), InternalPage::MakeEntry(separator, right_page_id)});
+      return;
+    }
+
+    auto *parent = path->back().AsMut<InternalPage>();
+    int pos = parent->ChildIndex(separator) + 1;
+    std::vector<Entry> entries = parent->Entries();
+    entries.insert(entries.begin() + pos, InternalPage::MakeEntry(std::move(separator), right_page_id));
+    if (InternalPage::Fits(entries)) {
+      parent->Build(entries);
+      return;
+    }
+
+    // The first key of the right half moves up; the right page keeps only its child.
+    size_t split = SplitPoint(entries, true);
+    std::vector<Entry> right_entries(entries.begin() + split, entries.end());
+    entries.resize(split);
+    separator = std::move(right_entries.front().first);
+    right_entries.front().first.clear();
+    WritePageGuard right_guard = bpm_->NewPageWrite(&right_page_id);
+    auto *right = right_guard.AsMut<InternalPage>();
+    right->Init();
+    right->Build(right_entries);
+    parent->Build(entries);
+  }
+}
+
+void PrefixBPlusTree::Remove(std::string_view key) {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  page_id_t page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    const auto *internal = guard.As<InternalPage>();
+    guard = bpm_->FetchPageWrite(internal->ValueAt(internal->ChildIndex(key)));
+  }
+  auto *leaf = guard.AsMut<LeafPage>();
+  int pos = leaf->KeyIndex(key);
+  if (pos == leaf->GetSize() || leaf->KeyAt(pos) != key) {
+    return;
+  }
+  std::vector<Entry> entries = leaf->Entries();
+  entries.erase(entries.begin() + pos);
+  leaf->Build(entries);
+}
+
+auto PrefixBPlusTree::Begin() -> PrefixIndexIterator {
+  ReadPageGuard guard = FindLeafRead({}, true);
+  if (!guard.IsValid()) {
+    return End();
+  }
+  page_id_t page_id = guard.PageId();
+  guard.Drop();
+  return {bpm_, page_id, 0};
+}
+
+auto PrefixBPlusTree::Begin(std::string_view key) -> PrefixIndexIterator {
+  ReadPageGuard guard = FindLeafRead(key, false);
+  if (!guard.IsValid()) {
+    return End();
+  }
+  page_id_t page_id = guard.PageId();
+  int ind = guard.As<LeafPage>()->KeyIndex(key);
+  guard.Drop();
+  return {bpm_, page_id, ind};
+}
+
+auto PrefixBPlusTree::End() -> PrefixIndexIterator { return {}; }
+
+}  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefix_b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/prefix_b_plus_tree_index.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/prefix_b_plus_tree_index.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Append the low width bytes of bits, most significant first. */
+void AppendBigEndian(std::string *out, uint64_t bits, int width) {
+  for (int i = width - 1; i >= 0; i--) {
+    out->push_back(static_cast<char>(bits >> (8 * i)));
+  }
+}
+
+/** Append a signed integer of width bytes so that it sorts as unsigned bytes. */
+void AppendSigned(std::string *out, int64_t value, int width) {
+  AppendBigEndian(out, static_cast<uint64_t>(value) ^ (uint64_t{1} << (8 * width - 1)), width);
+}
+
+}  // namespace
+
+BPlusTreePrefixIndex::BPlusTreePrefixIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                           BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)) {
+  page_id_t header_page_id;
+  buffer_pool_manager->NewPage(&header_page_id);
+  container_ = std::make_unique<PrefixBPlusTree>(GetMetadata()->GetName(), header_page_id, buffer_pool_manager);
+  buffer_pool_manager->UnpinPage(header_page_id, true);
+}
+
+auto BPlusTreePrefixIndex::EncodeKey(const Tuple &key, const Schema &key_schema) -> std::string {
+  std::string out;
+  for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+    Value value = key.GetValue(&key_schema, i);
+    if (value.IsNull()) {
+      out.push_back('\0');
+      continue;
+    }
+    out.push_back('\1');
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendSigned(&out, value.GetAs<int8_t>(), 1);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned(&out, value.GetAs<int16_t>(), 2);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned(&out, value.GetAs<int32_t>(), 4);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned(&out, value.GetAs<int64_t>(), 8);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(&out, value.GetAs<uint64_t>(), 8);
+        break;
+      case TypeId::DECIMAL: {
+        auto decimal = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &decimal, sizeof(bits));
+        // Negative numbers sort backwards by their bits, so flip them all; positive ones only need the sign set.
+        bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+        AppendBigEndian(&out, bits, 8);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        const char *data = value.GetData();
+        uint32_t length = value.GetLength() - 1;
+        for (uint32_t j = 0; j < length; j++) {
+          out.push_back(data[j]);
+          if (data[j] == '\0') {
+            out.push_back('\xff');
+          }
+        }
+        out.append(2, '\0');
+        break;
+      }
+      default:
+        throw NotImplementedException("unsupported column type in prefix_btree index key");
+    }
+  }
+  return out;
+}
+
+auto BPlusTreePrefixIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  return container_->Insert(EncodeKey(key, *GetKeySchema()), rid);
+}
+
+void BPlusTreePrefixIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_->Remove(EncodeKey(key, *GetKeySchema()));
+}
+
+void BPlusTreePrefixIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_->GetValue(EncodeKey(key, *GetKeySchema()), result);
+}
+
+auto BPlusTreePrefixIndex::GetBeginIterator() -> PrefixIndexIterator { return container_->Begin(); }
+
+auto BPlusTreePrefixIndex::GetBeginIterator(const Tuple &key) -> PrefixIndexIterator {
+  return container_->Begin(EncodeKey(key, *GetKeySchema()));
+}
+
+auto BPlusTreePrefixIndex::GetEndIterator() -> PrefixIndexIterator { return container_->End(); }
+
+}  // namespace bustub
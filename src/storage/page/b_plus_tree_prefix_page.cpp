@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_prefix_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_prefix_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_prefix_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+static_assert(sizeof(BPlusTreePrefixPage) == BPlusTreePrefixPage::HEADER_SIZE);
+
+auto BPlusTreePrefixPage::RequiredSize(const std::vector<Entry> &entries, bool skip_first) -> size_t {
+  size_t prefix_length = CommonPrefixLength(entries, skip_first);
+  size_t size = HEADER_SIZE + entries.size() * SLOT_SIZE + prefix_length;
+  for (size_t i = skip_first ? 1 : 0; i < entries.size(); i++) {
+    size += entries[i].first.size() - prefix_length;
+  }
+  return size;
+}
+
+auto BPlusTreePrefixPage::CommonPrefixLength(const std::vector<Entry> &entries, bool skip_first) -> size_t {
+  size_t first = skip_first ? 1 : 0;
+  if (entries.size() <= first) {
+    return 0;
+  }
+  // Keys are sorted, so whatever the first and last keys share, every key in between shares too.
+  const std::string &lo = entries[first].first;
+  const std::string &hi = entries.back().first;
+  size_t length = std::min(lo.size(), hi.size());
+  return std::mismatch(lo.begin(), lo.begin() + length, hi.begin()).first - lo.begin();
+}
+
+auto BPlusTreePrefixPage::Prefix() const -> std::string_view {
+  return {reinterpret_cast<const char *>(this) + bustub_page_size - prefix_length_, prefix_length_};
+}
+
+auto BPlusTreePrefixPage::SlotAt(int index) const -> const Slot * {
+  return reinterpret_cast<const Slot *>(reinterpret_cast<const char *>(this) + HEADER_SIZE + index * SLOT_SIZE);
+}
+
+auto BPlusTreePrefixPage::SuffixAt(int index) const -> std::string_view {
+  const Slot *slot = SlotAt(index);
+  return {reinterpret_cast<const char *>(this) + slot->offset_, slot->length_};
+}
+
+auto BPlusTreePrefixPage::KeyAt(int index) const -> std::string {
+  std::string key(Prefix());
+  key.append(SuffixAt(index));
+  return key;
+}
+
+auto BPlusTreePrefixPage::PayloadAt(int index) const -> uint64_t {
+  uint64_t payload;
+  memcpy(&payload, SlotAt(index)->payload_, sizeof(payload));
+  return payload;
+}
+
+auto BPlusTreePrefixPage::FreeSpace() const -> size_t { return heap_begin_ - HEADER_SIZE - GetSize() * SLOT_SIZE; }
+
+auto BPlusTreePrefixPage::Entries() const -> std::vector<Entry> {
+  std::vector<Entry> entries;
+  entries.reserve(GetSize() + 1);
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), PayloadAt(i));
+  }
+  return entries;
+}
+
+void BPlusTreePrefixPage::Build(const std::vector<Entry> &entries, bool skip_first) {
+  size_t prefix_length = CommonPrefixLength(entries, skip_first);
+  char *data = reinterpret_cast<char *>(this);
+  size_t heap_begin = bustub_page_size - prefix_length;
+  if (prefix_length != 0) {
+    memcpy(data + heap_begin, entries.back().first.data(), prefix_length);
+  }
+  for (size_t i = 0; i < entries.size(); i++) {
+    size_t suffix_length = i == 0 && skip_first ? 0 : entries[i].first.size() - prefix_length;
+    heap_begin -= suffix_length;
+    memcpy(data + heap_begin, entries[i].first.data() + prefix_length, suffix_length);
+    auto *slot = reinterpret_cast<Slot *>(data + HEADER_SIZE + i * SLOT_SIZE);
+    slot->offset_ = static_cast<uint16_t>(heap_begin);
+    slot->length_ = static_cast<uint16_t>(suffix_length);
+    memcpy(slot->payload_, &entries[i].second, sizeof(entries[i].second));
+  }
+  BUSTUB_ASSERT(heap_begin >= HEADER_SIZE + entries.size() * SLOT_SIZE, "entries do not fit in the page");
+  prefix_length_ = static_cast<uint16_t>(prefix_length);
+  heap_begin_ = static_cast<uint16_t>(heap_begin);
+  SetSize(static_cast<int>(entries.size()));
+}
+
+auto BPlusTreePrefixPage::ComparePrefix(std::string_view key) const -> int {
+  std::string_view prefix = Prefix();
+  int cmp = key.substr(0, prefix.size()).compare(prefix);
+  if (cmp != 0) {
+    return cmp;
+  }
+  return key.size() < prefix.size() ? -1 : 0;
+}
+
+auto BPlusTreePrefixPage::CompareSuffix(std::string_view key_rest, int index) const -> int {
+  return key_rest.compare(SuffixAt(index));
+}
+
+auto BPlusTreePrefixPage::Search(std::string_view key, int begin, bool upper) const -> int {
+  int l = begin;
+  int r = GetSize();
+  if (l >= r) {
+    return r;
+  }
+  // The prefix settles the comparison with every key at once unless key starts with it.
+  int prefix_cmp = ComparePrefix(key);
+  if (prefix_cmp != 0) {
+    return prefix_cmp < 0 ? l : r;
+  }
+  std::string_view key_rest = key.substr(prefix_length_);
+  while (l < r) {
+    int mid = (l + r) >> 1;
+    int cmp = CompareSuffix(key_rest, mid);
+    if (cmp > 0 || (upper && cmp == 0)) {
+      l = mid + 1;
+    } else {
+      r = mid;
+    }
+  }
+  return l;
+}
+
+void BPlusTreePrefixLeafPage::Init() {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetMaxSize(0);
+  SetNextPageId(INVALID_PAGE_ID);
+  BPlusTreePrefixPage::Build({}, false);
+}
+
+void BPlusTreePrefixInternalPage::Init() {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetMaxSize(0);
+  SetNextPageId(INVALID_PAGE_ID);
+  BPlusTreePrefixPage::Build({}, true);
+}
+
+auto BPlusTreePrefixInternalPage::ChildIndex(std::string_view key) const -> int { return UpperBound(key, 1) - 1; }
+
+}  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_list_page.cpp
+//
+// Identification: src/storage/page/posting_list_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/posting_list_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+static_assert(sizeof(PostingList) == 8 + PostingList::INLINE_SIZE);
+static_assert(sizeof(PostingListPage) == PostingListPage::HEADER_SIZE);
+
+namespace {
+
+auto VarintSize(uint64_t value) -> size_t {
+  size_t size = 1;
+  for (; value >= 0x80; value >>= 7) {
+    size++;
+  }
+  return size;
+}
+
+}  // namespace
+
+auto RidDeltaCodec::EncodedSize(const std::vector<RID> &rids, size_t begin, size_t end) -> size_t {
+  size_t size = 0;
+  uint64_t prev = 0;
+  for (size_t i = begin; i < end; i++) {
+    auto value = static_cast<uint64_t>(rids[i].Get());
+    size += VarintSize(value - prev);
+    prev = value;
+  }
+  return size;
+}
+
+auto RidDeltaCodec::FitCount(const std::vector<RID> &rids, size_t begin, size_t capacity) -> size_t {
+  size_t size = 0;
+  uint64_t prev = 0;
+  size_t end = begin;
+  for (; end < rids.size(); end++) {
+    auto value = static_cast<uint64_t>(rids[end].Get());
+    size += VarintSize(value - prev);
+    if (size > capacity) {
+      break;
+    }
+    prev = value;
+  }
+  return end;
+}
+
+auto RidDeltaCodec::Encode(const std::vector<RID> &rids, size_t begin, size_t end, char *out) -> size_t {
+  char *pos = out;
+  uint64_t prev = 0;
+  for (size_t i = begin; i < end; i++) {
+    auto value = static_cast<uint64_t>(rids[i].Get());
+    BUSTUB_ASSERT(i == begin || value > prev, "posting list RIDs must be sorted and distinct");
+    uint64_t delta = value - prev;
+    for (; delta >= 0x80; delta >>= 7) {
+      *pos++ = static_cast<char>((delta & 0x7f) | 0x80);
+    }
+    *pos++ = static_cast<char>(delta);
+    prev = value;
+  }
+  return pos - out;
+}
+
+void RidDeltaCodec::Decode(const char *data, uint32_t count, std::vector<RID> *rids) {
+  const auto *pos = reinterpret_cast<const uint8_t *>(data);
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint64_t delta = 0;
+    int shift = 0;
+    for (; (*pos & 0x80) != 0; pos++, shift += 7) {
+      delta |= static_cast<uint64_t>(*pos & 0x7f) << shift;
+    }
+    delta |= static_cast<uint64_t>(*pos++) << shift;
+    value += delta;
+    rids->emplace_back(static_cast<int64_t>(value));
+  }
+}
+
+PostingList::PostingList(RID rid) { SetInline({rid}); }
+
+auto PostingList::SetInline(const std::vector<RID> &rids) -> bool {
+  if (RidDeltaCodec::EncodedSize(rids, 0, rids.size()) > INLINE_SIZE) {
+    return false;
+  }
+  RidDeltaCodec::Encode(rids, 0, rids.size(), data_);
+  count_ = rids.size();
+  overflow_page_id_ = INVALID_PAGE_ID;
+  return true;
+}
+
+void PostingList::SetOverflow(page_id_t overflow_page_id, uint32_t count) {
+  overflow_page_id_ = overflow_page_id;
+  count_ = count;
+}
+
+void PostingList::GetInline(std::vector<RID> *rids) const {
+  BUSTUB_ASSERT(IsInline(), "posting list is in overflow pages");
+  RidDeltaCodec::Decode(data_, count_, rids);
+}
+
+void PostingListPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  count_ = 0;
+  size_ = 0;
+  reserved_ = 0;
+  last_rid_ = 0;
+}
+
+void PostingListPage::GetRids(std::vector<RID> *rids) const { RidDeltaCodec::Decode(data_, count_, rids); }
+
+auto PostingListPage::SetRids(const std::vector<RID> &rids, size_t begin, size_t end) -> bool {
+  size_t size = RidDeltaCodec::EncodedSize(rids, begin, end);
+  if (size > Capacity()) {
+    return false;
+  }
+  RidDeltaCodec::Encode(rids, begin, end, data_);
+  count_ = end - begin;
+  size_ = size;
+  last_rid_ = end > begin ? rids[end - 1].Get() : 0;
+  return true;
+}
+
+}  // namespace bustub
@@ -28,20 +28,25 @@ void TablePage::Init() {
   num_deleted_tuples_ = 0;
 }
 
+auto TablePage::GetFreeSpace() const -> size_t {
+  size_t slot_end_offset = num_tuples_ > 0 ? std::get<0>(tuple_info_[num_tuples_ - 1]) : bustub_page_size;
+  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
+  return slot_end_offset > offset_size ? slot_end_offset - offset_size : 0;
+}
+
 auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
   size_t slot_end_offset;
   if (num_tuples_ > 0) {
     auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
     slot_end_offset = offset;
   } else {
-    slot_end_offset = BUSTUB_PAGE_SIZE;
+    slot_end_offset = bustub_page_size;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
   auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
-  if (tuple_offset < offset_size) {
+  if (slot_end_offset < offset_size + tuple.GetLength()) {
     return std::nullopt;
   }
-  return tuple_offset;
+  return slot_end_offset - tuple.GetLength();
 }
 
 auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
@@ -64,8 +69,10 @@ void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
   auto &[offset, size, old_meta] = tuple_info_[tuple_id];
   if (!old_meta.is_deleted_ && meta.is_deleted_) {
     num_deleted_tuples_++;
+    // A deleted tuple doesn't forward anymore, the slot of a forwarded one is like that of any deleted tuple.
+    size &= ~FORWARD_FLAG;
   }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  old_meta = meta;
 }
 
 auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
@@ -75,8 +82,8 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   }
   auto &[offset, size, meta] = tuple_info_[tuple_id];
   Tuple tuple;
-  tuple.data_.resize(size);
-  memmove(tuple.data_.data(), page_start_ + offset, size);
+  tuple.data_.resize(size & ~FORWARD_FLAG);
+  memmove(tuple.data_.data(), page_start_ + offset, size & ~FORWARD_FLAG);
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
@@ -90,13 +97,126 @@ auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   return meta;
 }
 
+auto TablePage::GetTupleData(const RID &rid) const -> std::pair<const char *, uint32_t> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, _] = tuple_info_[tuple_id];
+  return {page_start_ + offset, size & ~FORWARD_FLAG};
+}
+
+auto TablePage::UpdateTupleInPlace(const Tuple &tuple, const RID &rid) -> bool {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return ResizeTuple(tuple_id, tuple.data_.data(), tuple.GetLength());
+}
+
+auto TablePage::ResizeTuple(uint16_t tuple_id, const char *data, uint16_t new_size) -> bool {
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  // The tuple keeps its end, and the tuples stored below it, from the later slots, move by as much as it grows or
+  // shrinks, so that the tuples stay in slot order from the end of the page down.
+  int shift = static_cast<int>(size & ~FORWARD_FLAG) - new_size;
+  size_t free_space_end = std::get<0>(tuple_info_[num_tuples_ - 1]);
+  if (shift < 0 &&
+      free_space_end - TABLE_PAGE_HEADER_SIZE - TUPLE_INFO_SIZE * num_tuples_ < static_cast<size_t>(-shift)) {
+    return false;
+  }
+  if (shift != 0) {
+    memmove(page_start_ + free_space_end + shift, page_start_ + free_space_end, offset - free_space_end);
+    for (uint16_t later_id = tuple_id + 1; later_id < num_tuples_; later_id++) {
+      std::get<0>(tuple_info_[later_id]) += shift;
+    }
+    offset += shift;
+  }
+  size = (size & FORWARD_FLAG) | new_size;
+  memcpy(page_start_ + offset, data, new_size);
+  return true;
+}
+
+auto TablePage::GetForward(const RID &rid) const -> std::optional<RID> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  // The tuple a forwarded slot points to is marked too, but deleted.
+  if ((size & FORWARD_FLAG) == 0 || meta.is_deleted_) {
+    return std::nullopt;
+  }
+  int64_t forward_rid;
+  memcpy(&forward_rid, page_start_ + offset, sizeof(forward_rid));
+  return RID(forward_rid);
+}
+
+auto TablePage::SetForward(const RID &rid, const RID &forward_rid) -> bool {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  int64_t data = forward_rid.Get();
+  if (!ResizeTuple(tuple_id, reinterpret_cast<const char *>(&data), sizeof(data))) {
+    return false;
+  }
+  std::get<1>(tuple_info_[tuple_id]) |= FORWARD_FLAG;
+  return true;
+}
+
+void TablePage::SetForwardedCopy(const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  BUSTUB_ASSERT(meta.is_deleted_, "a forwarded tuple is hidden from scans as deleted");
+  size |= FORWARD_FLAG;
+}
+
+void TablePage::ClearForwardedCopy(const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  size &= ~FORWARD_FLAG;
+  // It was inserted deleted, and is only counted as deleted now that Compact may reclaim it.
+  if (meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+}
+
+auto TablePage::Compact() -> size_t {
+  if (num_deleted_tuples_ == 0) {
+    return 0;
+  }
+  // Tuples are stored in slot order from the end of the page down, so each one only ever moves up, past tuples that
+  // have already moved. A tombstone takes the offset of the tuple before it, for GetNextTupleOffset to keep working.
+  size_t free_space_end = num_tuples_ > 0 ? std::get<0>(tuple_info_[num_tuples_ - 1]) : bustub_page_size;
+  size_t tuple_end = bustub_page_size;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    // A deleted tuple that is still marked forwarded is the new place of a tuple that moved, see SetForwardedCopy.
+    if (meta.is_deleted_ && (size & FORWARD_FLAG) == 0) {
+      size = 0;
+    }
+    tuple_end -= size & ~FORWARD_FLAG;
+    if (offset != tuple_end) {
+      memmove(page_start_ + tuple_end, page_start_ + offset, size & ~FORWARD_FLAG);
+      offset = static_cast<uint16_t>(tuple_end);
+    }
+  }
+  return tuple_end - free_space_end;
+}
+
 void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
     throw bustub::Exception("Tuple ID out of range");
   }
   auto &[offset, size, old_meta] = tuple_info_[tuple_id];
-  if (size != tuple.GetLength()) {
+  if ((size & ~FORWARD_FLAG) != tuple.GetLength()) {
     throw bustub::Exception("Tuple size mismatch");
   }
   if (!old_meta.is_deleted_ && meta.is_deleted_) {
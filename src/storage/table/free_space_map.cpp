@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm, page_id_t first_page_id) : bpm_(bpm) {
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<FreeSpaceMapPage>();
+    map_page_ids_.push_back(page_id);
+    for (uint32_t i = 0; i < page->GetCount(); i++) {
+      const auto &entry = page->EntryAt(i);
+      pages_[entry.page_id_] = {static_cast<uint32_t>(slots_.size()), entry.category_, entry.num_tuples_};
+      slots_.push_back(entry.page_id_);
+      buckets_[entry.category_].insert(entry.page_id_);
+    }
+    page_id = page->GetNextPageId();
+  }
+}
+
+auto FreeSpaceMap::CategoryOf(size_t free_bytes) -> uint32_t {
+  return std::min<size_t>(CATEGORY_COUNT - 1, free_bytes * CATEGORY_COUNT / bustub_page_size);
+}
+
+void FreeSpaceMap::Release(page_id_t page_id, size_t free_bytes, uint32_t num_tuples) {
+  BUSTUB_ASSERT(pages_.count(page_id) == 0, "page is in the free space map already");
+  auto category = CategoryOf(free_bytes);
+  if (category == 0) {
+    return;
+  }
+  auto slot = static_cast<uint32_t>(slots_.size());
+  pages_[page_id] = {slot, static_cast<uint16_t>(category), static_cast<uint16_t>(num_tuples)};
+  slots_.push_back(page_id);
+  buckets_[category].insert(page_id);
+  WriteSlot(slot);
+}
+
+auto FreeSpaceMap::Take(size_t tuple_size) -> page_id_t {
+  // The smallest category whose pages all have tuple_size bytes free.
+  size_t min_category = std::max<size_t>(1, (tuple_size * CATEGORY_COUNT + bustub_page_size - 1) / bustub_page_size);
+  for (size_t category = min_category; category < CATEGORY_COUNT; category++) {
+    if (buckets_[category].empty()) {
+      continue;
+    }
+    page_id_t page_id = *buckets_[category].begin();
+    Remove(page_id);
+    return page_id;
+  }
+  return INVALID_PAGE_ID;
+}
+
+auto FreeSpaceMap::Remove(page_id_t page_id) -> bool {
+  auto it = pages_.find(page_id);
+  if (it == pages_.end()) {
+    return false;
+  }
+  auto slot = it->second.slot_;
+  buckets_[it->second.category_].erase(page_id);
+  pages_.erase(it);
+
+  // Move the last entry into the slot of the removed page, to keep the map pages packed.
+  page_id_t last_page_id = slots_.back();
+  slots_.pop_back();
+  if (slot < slots_.size()) {
+    slots_[slot] = last_page_id;
+    pages_[last_page_id].slot_ = slot;
+    WriteSlot(slot);
+  }
+  WriteCount();
+  return true;
+}
+
+void FreeSpaceMap::GetTupleCounts(std::unordered_map<page_id_t, uint32_t> *tuple_counts) const {
+  for (const auto &[page_id, info] : pages_) {
+    (*tuple_counts)[page_id] = info.num_tuples_;
+  }
+}
+
+void FreeSpaceMap::WriteSlot(uint32_t slot) {
+  uint32_t page_index = slot / FreeSpaceMapPage::Capacity();
+  if (page_index == map_page_ids_.size()) {
+    page_id_t page_id;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+    guard.AsMut<FreeSpaceMapPage>()->Init();
+    if (!map_page_ids_.empty()) {
+      auto prev_guard = bpm_->FetchPageWrite(map_page_ids_.back());
+      prev_guard.AsMut<FreeSpaceMapPage>()->SetNextPageId(page_id);
+    }
+    map_page_ids_.push_back(page_id);
+  }
+  auto guard = bpm_->FetchPageWrite(map_page_ids_[page_index]);
+  auto *page = guard.AsMut<FreeSpaceMapPage>();
+  page_id_t page_id = slots_[slot];
+  const auto &info = pages_[page_id];
+  page->SetEntryAt(slot % FreeSpaceMapPage::Capacity(), {page_id, info.category_, info.num_tuples_});
+  if (slot + 1 == slots_.size()) {
+    page->SetCount(slot % FreeSpaceMapPage::Capacity() + 1);
+  }
+}
+
+void FreeSpaceMap::WriteCount() {
+  // The map shrank by one entry: the page that held the last entry loses it.
+  auto size = static_cast<uint32_t>(slots_.size());
+  auto guard = bpm_->FetchPageWrite(map_page_ids_[size / FreeSpaceMapPage::Capacity()]);
+  guard.AsMut<FreeSpaceMapPage>()->SetCount(size % FreeSpaceMapPage::Capacity());
+}
+
+}  // namespace bustub
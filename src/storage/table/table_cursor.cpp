@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_cursor.cpp
+//
+// Identification: src/storage/table/table_cursor.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_cursor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+TableCursor::TableCursor(TableIterator &&iter)
+    : table_heap_(iter.table_heap_),
+      stop_at_rid_(iter.stop_at_rid_),
+      tuple_counts_(std::move(iter.tuple_counts_)),
+      scan_token_(std::move(iter.scan_token_)),
+      prefetcher_(std::move(iter.prefetcher_)),
+      page_data_(new char[bustub_page_size]) {
+  // The iterator is on its first tuple already, or at the end.
+  LoadPage(iter.rid_.GetPageId());
+  next_slot_ = iter.rid_.GetSlotNum();
+}
+
+auto TableCursor::Next() -> bool {
+  while (page_id_ != INVALID_PAGE_ID) {
+    for (; next_slot_ < num_tuples_; next_slot_++) {
+      RID rid{page_id_, next_slot_};
+      if (Page()->GetTupleMeta(rid).is_deleted_) {
+        continue;
+      }
+      forwarded_.reset();
+      if (Page()->GetForward(rid) != std::nullopt) {
+        // The slot may have been deleted since the page was copied.
+        forwarded_ = table_heap_->GetTuple(rid, AccessType::Scan);
+        if (forwarded_->first.is_deleted_) {
+          continue;
+        }
+      }
+      slot_ = next_slot_++;
+      return true;
+    }
+    LoadPage(next_page_id_);
+  }
+  return false;
+}
+
+auto TableCursor::GetTupleMeta() const -> TupleMeta {
+  return forwarded_ ? forwarded_->first : Page()->GetTupleMeta(GetRID());
+}
+
+auto TableCursor::GetTupleView() const -> TupleView {
+  if (forwarded_) {
+    return forwarded_->second;
+  }
+  auto [data, size] = Page()->GetTupleData(GetRID());
+  return {data, size, GetRID()};
+}
+
+void TableCursor::GetTuple(Tuple *tuple) const {
+  if (forwarded_) {
+    *tuple = forwarded_->second;
+    return;
+  }
+  auto [data, size] = Page()->GetTupleData(GetRID());
+  tuple->data_.assign(data, data + size);
+  tuple->rid_ = GetRID();
+}
+
+void TableCursor::LoadPage(page_id_t page_id) {
+  page_id_ = page_id;
+  next_page_id_ = INVALID_PAGE_ID;
+  num_tuples_ = 0;
+  next_slot_ = 0;
+  if (page_id_ != INVALID_PAGE_ID) {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(page_id_, AccessType::Scan);
+    memcpy(page_data_.get(), page_guard.GetData(), bustub_page_size);
+    page_guard.Drop();
+
+    // Stop where the iterator would have: at the tuple counts taken when it was made, and at the stop tuple.
+    num_tuples_ = Page()->GetNumTuples();
+    if (auto it = tuple_counts_.find(page_id_); it != tuple_counts_.end()) {
+      num_tuples_ = std::min(num_tuples_, it->second);
+    }
+    if (page_id_ == stop_at_rid_.GetPageId()) {
+      num_tuples_ = std::min(num_tuples_, stop_at_rid_.GetSlotNum());
+    } else {
+      next_page_id_ = Page()->GetNextPageId();
+    }
+  }
+  prefetcher_.Advance(page_id_);
+}
+
+}  // namespace bustub
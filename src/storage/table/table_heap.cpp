@@ -10,9 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
-#include <mutex>  // NOLINT
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -26,78 +32,221 @@
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
-  // Initialize the first table page.
+TableHeap::TableHeap(BufferPoolManager *bpm)
+    : bpm_(bpm), free_space_map_(bpm), scan_token_(std::make_shared<char>()) {
+  // Initialize the first table page, and leave it to the first target that needs a page.
   auto guard = bpm->NewPageGuarded(&first_page_id_);
   last_page_id_ = first_page_id_;
   auto first_page = guard.AsMut<TablePage>();
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init();
+  free_space_map_.Release(first_page_id_, first_page->GetFreeSpace(), 0);
 }
 
+TableHeap::~TableHeap() { StopBackgroundVacuum(); }
+
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
-  std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
-  while (true) {
-    auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
-      break;
-    }
-
-    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
-    BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
-
-    page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
-    BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+  auto [page_guard, rid] = InsertIntoTarget(meta, tuple);
 
-    page->SetNextPageId(next_page_id);
-
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+  if (lock_mgr != nullptr) {
+    lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, rid);
+  }
 
-    page_guard.Drop();
+  page_guard.Drop();
 
-    // acquire latch here as TSAN complains. Given we only have one insertion thread, this is fine.
-    npg->WLatch();
-    auto next_page_guard = WritePageGuard{bpm_, npg};
+  return rid;
+}
 
-    last_page_id_ = next_page_id;
-    page_guard = std::move(next_page_guard);
+auto TableHeap::InsertIntoTarget(const TupleMeta &meta, const Tuple &tuple) -> std::pair<WritePageGuard, RID> {
+  auto &target = targets_[std::hash<std::thread::id>()(std::this_thread::get_id()) % TABLE_HEAP_INSERT_TARGETS];
+  std::unique_lock<std::mutex> target_guard(target.latch_);
+  WritePageGuard page_guard;
+  if (target.page_id_ != INVALID_PAGE_ID) {
+    page_guard = bpm_->FetchPageWrite(target.page_id_);
   }
-  auto last_page_id = last_page_id_;
+  while (!page_guard.IsValid() || page_guard.As<TablePage>()->GetNextTupleOffset(meta, tuple) == std::nullopt) {
+    size_t free_space = 0;
+    uint32_t num_tuples = 0;
+    if (page_guard.IsValid()) {
+      auto page = page_guard.As<TablePage>();
+      // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
+      BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+      free_space = page->GetFreeSpace();
+      num_tuples = page->GetNumTuples();
+      page_guard.Drop();
+    }
+    page_guard = SwapTargetPage(&target, free_space, num_tuples, tuple.GetLength());
+  }
+  auto page_id = target.page_id_;
 
   auto page = page_guard.AsMut<TablePage>();
   auto slot_id = *page->InsertTuple(meta, tuple);
 
-  // only allow one insertion at a time, otherwise it will deadlock.
-  guard.unlock();
+  // only allow one insertion into a page at a time, otherwise it will deadlock.
+  target_guard.unlock();
 
-  if (lock_mgr != nullptr) {
-    lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id});
+  return {std::move(page_guard), RID(page_id, slot_id)};
+}
+
+auto TableHeap::SwapTargetPage(InsertTarget *target, size_t free_space, uint32_t num_tuples, size_t tuple_size)
+    -> WritePageGuard {
+  // The page of the target changes under latch_, so that Vacuum sees every page either in the map or with a target.
+  std::scoped_lock<std::mutex> guard(latch_);
+  if (target->page_id_ != INVALID_PAGE_ID) {
+    free_space_map_.Release(target->page_id_, free_space, num_tuples);
+  }
+  page_id_t next_page_id = free_space_map_.Take(tuple_size);
+  if (next_page_id != INVALID_PAGE_ID) {
+    target->page_id_ = next_page_id;
+    return bpm_->FetchPageWrite(next_page_id);
   }
 
-  page_guard.Drop();
+  // No page has room, append one to the heap. Pages are only appended under latch_.
+  auto npg = bpm_->NewPage(&next_page_id);
+  BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
-  return RID(last_page_id, slot_id);
+  // acquire latch here as TSAN complains. Nobody knows of the page yet, so this is fine.
+  npg->WLatch();
+  auto next_page_guard = WritePageGuard{bpm_, npg};
+  next_page_guard.AsMut<TablePage>()->Init();
+
+  auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+  last_page_guard.AsMut<TablePage>()->SetNextPageId(next_page_id);
+  last_page_id_ = next_page_id;
+  target->page_id_ = next_page_id;
+  return next_page_guard;
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
+  auto forward_rid = page->GetForward(rid);
   page->UpdateTupleMeta(meta, rid);
+  if (meta.is_deleted_) {
+    vacuum_pending_ = true;
+    page_guard.Drop();
+    // The tuple a deleted slot forwarded to is deleted with it.
+    if (forward_rid != std::nullopt) {
+      auto copy_guard = bpm_->FetchPageWrite(forward_rid->GetPageId());
+      copy_guard.AsMut<TablePage>()->ClearForwardedCopy(*forward_rid);
+    }
+  }
 }
 
-auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+auto TableHeap::UpdateTuple(const TupleMeta &meta, const Tuple &tuple, RID rid) -> RID {
+  BUSTUB_ASSERT(!meta.is_deleted_, "delete tuples with UpdateTupleMeta");
+  // Only one page is latched at a time, as readers latch the page of a forwarded tuple after its slot's.
+  auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  auto page = page_guard.AsMut<TablePage>();
+  auto forward_rid = page->GetForward(rid);
+  if (forward_rid == std::nullopt) {
+    if (page->UpdateTupleInPlace(tuple, rid)) {
+      page->UpdateTupleMeta(meta, rid);
+      return rid;
+    }
+  } else {
+    page->UpdateTupleMeta(meta, rid);
+    page_guard.Drop();
+    auto copy_guard = bpm_->FetchPageWrite(forward_rid->GetPageId());
+    if (copy_guard.AsMut<TablePage>()->UpdateTupleInPlace(tuple, *forward_rid)) {
+      return rid;
+    }
+  }
+  page_guard.Drop();
+
+  // The tuple moves to wherever an insert would put it. It is marked deleted there, so that scans only find it
+  // through its slot.
+  TupleMeta copy_meta = meta;
+  copy_meta.is_deleted_ = true;
+  auto [copy_guard, copy_rid] = InsertIntoTarget(copy_meta, tuple);
+  copy_guard.AsMut<TablePage>()->SetForwardedCopy(copy_rid);
+  copy_guard.Drop();
+
+  page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  page = page_guard.AsMut<TablePage>();
+  if (forward_rid != std::nullopt) {
+    // The slot already holds a RID, so it has room for the new one.
+    BUSTUB_ENSURE(page->SetForward(rid, copy_rid), "a forwarded slot holds a RID");
+    page_guard.Drop();
+    auto old_copy_guard = bpm_->FetchPageWrite(forward_rid->GetPageId());
+    old_copy_guard.AsMut<TablePage>()->ClearForwardedCopy(*forward_rid);
+    return rid;
+  }
+  if (page->SetForward(rid, copy_rid)) {
+    page->UpdateTupleMeta(meta, rid);
+    return rid;
+  }
+
+  // The tuple was smaller than a RID, and its page has filled up: it can't even forward. Delete it, and let the copy
+  // take its place.
+  TupleMeta deleted_meta = page->GetTupleMeta(rid);
+  deleted_meta.is_deleted_ = true;
+  page->UpdateTupleMeta(deleted_meta, rid);
+  vacuum_pending_ = true;
+  page_guard.Drop();
+  copy_guard = bpm_->FetchPageWrite(copy_rid.GetPageId());
+  auto copy_page = copy_guard.AsMut<TablePage>();
+  copy_page->UpdateTupleMeta(meta, copy_rid);
+  copy_page->ClearForwardedCopy(copy_rid);
+  return copy_rid;
+}
+
+auto TableHeap::GetTuple(RID rid, AccessType access_type) -> std::pair<TupleMeta, Tuple> {
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId(), access_type);
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
+  if (auto forward_rid = page->GetForward(rid); forward_rid != std::nullopt) {
+    // The slot's page stays latched, so that the tuple can't move again before it is read.
+    if (forward_rid->GetPageId() == rid.GetPageId()) {
+      tuple = page->GetTuple(*forward_rid).second;
+    } else {
+      auto copy_guard = bpm_->FetchPageRead(forward_rid->GetPageId(), access_type);
+      tuple = copy_guard.As<TablePage>()->GetTuple(*forward_rid).second;
+    }
+  }
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTuples(const std::vector<RID> &rids, AccessType access_type)
+    -> std::vector<std::pair<TupleMeta, Tuple>> {
+  std::vector<page_id_t> page_ids;
+  std::unordered_map<page_id_t, size_t> page_index;
+  for (const auto &rid : rids) {
+    if (page_index.emplace(rid.GetPageId(), page_ids.size()).second) {
+      page_ids.push_back(rid.GetPageId());
+    }
+  }
+  std::vector<std::pair<TupleMeta, Tuple>> tuples(rids.size());
+  std::vector<size_t> missed;
+  {
+    auto page_guards = bpm_->FetchPagesRead(page_ids, access_type);
+    for (size_t i = 0; i < rids.size(); i++) {
+      auto &page_guard = page_guards[page_index[rids[i].GetPageId()]];
+      if (!page_guard.IsValid()) {
+        missed.push_back(i);
+        continue;
+      }
+      auto page = page_guard.As<TablePage>();
+      // A forwarded tuple may be on a page that is not in the batch.
+      if (page->GetForward(rids[i]) != std::nullopt) {
+        missed.push_back(i);
+        continue;
+      }
+      tuples[i] = page->GetTuple(rids[i]);
+      tuples[i].second.rid_ = rids[i];
+    }
+  }
+  // The pool had no room for all the pages at once, or the tuples were forwarded: read the rest one by one now that
+  // the batch is unpinned.
+  for (size_t i : missed) {
+    tuples[i] = GetTuple(rids[i], access_type);
+  }
+  return tuples;
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
@@ -105,16 +254,44 @@ auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
 }
 
 auto TableHeap::MakeIterator() -> TableIterator {
+  // Hold every target, so that no insert is under way while the number of tuples of the pages open to inserts is
+  // taken. The iterator stops at those, as it does at the last page.
+  std::vector<std::unique_lock<std::mutex>> target_guards;
+  target_guards.reserve(targets_.size());
+  for (auto &target : targets_) {
+    target_guards.emplace_back(target.latch_);
+  }
   std::unique_lock<std::mutex> guard(latch_);
+
+  std::unordered_map<page_id_t, uint32_t> tuple_counts;
+  free_space_map_.GetTupleCounts(&tuple_counts);
+  for (auto &target : targets_) {
+    if (target.page_id_ != INVALID_PAGE_ID) {
+      auto page_guard = bpm_->FetchPageRead(target.page_id_);
+      tuple_counts[target.page_id_] = page_guard.As<TablePage>()->GetNumTuples();
+    }
+  }
   auto last_page_id = last_page_id_;
+  auto scan_token = scan_token_;
+  uint32_t last_num_tuples;
+  if (auto it = tuple_counts.find(last_page_id); it != tuple_counts.end()) {
+    last_num_tuples = it->second;
+  } else {
+    auto page_guard = bpm_->FetchPageRead(last_page_id);
+    last_num_tuples = page_guard.As<TablePage>()->GetNumTuples();
+  }
   guard.unlock();
+  target_guards.clear();
 
-  auto page_guard = bpm_->FetchPageRead(last_page_id);
-  auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  return {this, {first_page_id_, 0}, {last_page_id, last_num_tuples}, std::move(tuple_counts), std::move(scan_token)};
 }
 
-auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
+auto TableHeap::MakeEagerIterator() -> TableIterator {
+  std::unique_lock<std::mutex> guard(latch_);
+  auto scan_token = scan_token_;
+  guard.unlock();
+  return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}, {}, std::move(scan_token)};
+}
 
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
@@ -122,4 +299,125 @@ void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tup
   page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
 }
 
+auto TableHeap::Vacuum(size_t max_pages) -> size_t {
+  std::scoped_lock<std::mutex> vacuum_guard(vacuum_latch_);
+  // Pages unlinked by this call are left to the next one. That also gives the readers that found a tuple of such a
+  // page through an index, just before it was deleted, the time to finish.
+  size_t deleted = FinishVacuumedPages();
+  if (vacuum_page_id_ == INVALID_PAGE_ID && max_pages > 0) {
+    vacuum_pending_ = false;
+    vacuum_page_id_ = first_page_id_;
+    vacuum_prev_page_id_ = INVALID_PAGE_ID;
+  }
+
+  for (size_t i = 0; i < max_pages && vacuum_page_id_ != INVALID_PAGE_ID; i++) {
+    // latch_ is taken for one page at a time, so that inserts that need a new page are not held up for long.
+    std::scoped_lock<std::mutex> guard(latch_);
+    page_id_t page_id = vacuum_page_id_;
+    auto page_guard = bpm_->FetchPageWrite(page_id);
+    auto *page = page_guard.AsMut<TablePage>();
+    vacuum_page_id_ = page->GetNextPageId();
+
+    // Only the pages of the targets get new tuples, so any other page stays all deleted while latch_ is held.
+    bool is_target = IsTargetPage(page_id);
+    if (page->GetNumDeletedTuples() == page->GetNumTuples() && !is_target && page_id != first_page_id_ &&
+        page_id != last_page_id_) {
+      page_guard.Drop();
+      free_space_map_.Remove(page_id);
+      compacted_pages_.erase(page_id);
+      // Iterators on the page still find the rest of the heap through it.
+      auto prev_guard = bpm_->FetchPageWrite(vacuum_prev_page_id_);
+      prev_guard.AsMut<TablePage>()->SetNextPageId(vacuum_page_id_);
+      unlinked_pages_.push_back(page_id);
+      continue;
+    }
+    vacuum_prev_page_id_ = page_id;
+    // The page of a target goes to the map with its new free space when the target is done with it.
+    if (page->Compact() == 0 || is_target) {
+      continue;
+    }
+    if (free_space_map_.Remove(page_id)) {
+      free_space_map_.Release(page_id, page->GetFreeSpace(), page->GetNumTuples());
+    } else {
+      compacted_pages_.insert(page_id);
+    }
+  }
+  return deleted;
+}
+
+auto TableHeap::IsTargetPage(page_id_t page_id) const -> bool {
+  return std::any_of(targets_.begin(), targets_.end(),
+                     [page_id](const InsertTarget &target) { return target.page_id_ == page_id; });
+}
+
+auto TableHeap::FinishVacuumedPages() -> size_t {
+  if (unlinked_pages_.empty() && compacted_pages_.empty()) {
+    return 0;
+  }
+  // Iterators copy the token under latch_, so none can be made until the pages are done.
+  std::scoped_lock<std::mutex> guard(latch_);
+  if (scan_token_.use_count() > 1) {
+    return 0;
+  }
+  for (auto page_id : compacted_pages_) {
+    // No tuple is added to a page that is neither in the map nor the page of a target, only updated in place.
+    auto page_guard = bpm_->FetchPageRead(page_id);
+    const auto *page = page_guard.As<TablePage>();
+    free_space_map_.Release(page_id, page->GetFreeSpace(), page->GetNumTuples());
+  }
+  compacted_pages_.clear();
+
+  size_t deleted = 0;
+  // A page that is still pinned is tried again by the next call.
+  auto it = std::remove_if(unlinked_pages_.begin(), unlinked_pages_.end(), [&](page_id_t page_id) {
+    if (!bpm_->DeletePage(page_id)) {
+      return false;
+    }
+    deleted++;
+    return true;
+  });
+  unlinked_pages_.erase(it, unlinked_pages_.end());
+  return deleted;
+}
+
+void TableHeap::StartBackgroundVacuum() {
+  StopBackgroundVacuum();
+  enable_background_vacuum_ = true;
+  background_vacuum_thread_ = new std::thread(&TableHeap::RunBackgroundVacuum, this);
+}
+
+void TableHeap::StopBackgroundVacuum() {
+  if (background_vacuum_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::scoped_lock lock(background_vacuum_latch_);
+    enable_background_vacuum_ = false;
+  }
+  background_vacuum_cv_.notify_one();
+  background_vacuum_thread_->join();
+  delete background_vacuum_thread_;
+  background_vacuum_thread_ = nullptr;
+}
+
+void TableHeap::RunBackgroundVacuum() {
+  while (enable_background_vacuum_) {
+    {
+      std::unique_lock lock(background_vacuum_latch_);
+      background_vacuum_cv_.wait_for(lock, table_heap_vacuum_interval, [&] { return !enable_background_vacuum_; });
+    }
+    if (!enable_background_vacuum_) {
+      break;
+    }
+    size_t max_pages = 0;
+    {
+      std::scoped_lock lock(vacuum_latch_);
+      if (vacuum_pending_ || vacuum_page_id_ != INVALID_PAGE_ID) {
+        max_pages = TABLE_HEAP_VACUUM_BATCH_PAGES;
+      }
+    }
+    Vacuum(max_pages);
+  }
+}
+
 }  // namespace bustub
@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
+#include <utility>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -20,51 +22,63 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid,
+                             std::unordered_map<page_id_t, uint32_t> tuple_counts, std::shared_ptr<void> scan_token)
+    : table_heap_(table_heap),
+      rid_(rid),
+      stop_at_rid_(stop_at_rid),
+      tuple_counts_(std::move(tuple_counts)),
+      scan_token_(std::move(scan_token)),
+      prefetcher_(table_heap->bpm_, SCAN_READAHEAD_DEPTH, [](const char *page_data) {
+        return reinterpret_cast<const TablePage *>(page_data)->GetNextPageId();
+      }) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
-  // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
-  }
+  // we move on to the first one that does, or set rid_ to invalid.
+  SeekTuple();
+  prefetcher_.Advance(rid_.GetPageId());
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_, AccessType::Scan); }
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
   if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
+    // Page ids don't grow along the heap: the ids of the pages Vacuum deletes are given out again.
     BUSTUB_ASSERT(
-        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() < stop_at_rid_.GetPageId() ||
+        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() != stop_at_rid_.GetPageId() ||
             /* case 2: cursor at the page before the tuple */
             (rid_.GetPageId() == stop_at_rid_.GetPageId() && next_tuple_id <= stop_at_rid_.GetSlotNum()),
         "iterate out of bound");
   }
 
   rid_ = RID{rid_.GetPageId(), next_tuple_id};
+  SeekTuple();
+  prefetcher_.Advance(rid_.GetPageId());
+
+  return *this;
+}
 
-  if (rid_ == stop_at_rid_) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
-  } else if (next_tuple_id < page->GetNumTuples()) {
-    // that's fine
-  } else {
-    auto next_page_id = page->GetNextPageId();
+void TableIterator::SeekTuple() {
+  // Pages may be empty, or hold tuples inserted after the iterator was created, when inserts fill several pages.
+  while (rid_.GetPageId() != INVALID_PAGE_ID && !(rid_ == stop_at_rid_)) {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+    auto page = page_guard.As<TablePage>();
+    uint32_t num_tuples = page->GetNumTuples();
+    if (auto it = tuple_counts_.find(rid_.GetPageId()); it != tuple_counts_.end()) {
+      num_tuples = std::min(num_tuples, it->second);
+    }
+    if (rid_.GetSlotNum() < num_tuples) {
+      return;
+    }
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
-    rid_ = RID{next_page_id, 0};
+    rid_ = RID{page->GetNextPageId(), 0};
   }
-
-  page_guard.Drop();
-
-  return *this;
+  rid_ = RID{INVALID_PAGE_ID, 0};
 }
 
 }  // namespace bustub
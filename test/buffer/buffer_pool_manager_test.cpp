@@ -12,11 +12,18 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -144,4 +151,444 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ShardedConcurrentTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t num_shards = 4;
+  const size_t num_pages = 200;
+  const size_t num_threads = 8;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, num_shards);
+  ASSERT_EQ(num_shards, bpm->GetNumShards());
+
+  // Scenario: every shard owns a quarter of the frames, so the first four pages of each shard fit in the pool.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: concurrent fetches across shards always see the data that was written, even with constant eviction.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      for (size_t round = 0; round < 5; ++round) {
+        for (size_t i = tid; i < num_pages; i += num_threads / 2) {
+          auto guard = bpm->FetchPageRead(page_ids[i]);
+          ASSERT_EQ(std::string("page ") + std::to_string(page_ids[i]), std::string(guard.GetData()));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: a shard with all of its frames pinned refuses new pages even if other shards have room.
+  std::vector<Page *> pinned;
+  for (size_t i = 0; i < buffer_pool_size / num_shards; ++i) {
+    auto *page = bpm->FetchPage(page_ids[i * num_shards]);
+    ASSERT_NE(nullptr, page);
+    pinned.push_back(page);
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[buffer_pool_size]));
+  EXPECT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[1], false));
+  for (size_t i = 0; i < pinned.size(); ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i * num_shards], false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundFlushTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_pages = 64;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: with a clean ratio of 1 the flusher writes back every unpinned dirty page without evicting it.
+  bpm->StartBackgroundFlush(1.0);
+  auto all_clean = [&] {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      if (bpm->GetPages()[i].IsDirty()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!all_clean() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(all_clean());
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+    char data[BUSTUB_PAGE_SIZE];
+    disk_manager->ReadPage(page_ids[i], data);
+    EXPECT_EQ(std::string("page ") + std::to_string(page_ids[i]), std::string(data));
+  }
+
+  // Scenario: pages modified while the flusher runs are never lost, whether evicted clean or dirty.
+  for (size_t i = buffer_pool_size; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  for (size_t round = 0; round < 3; ++round) {
+    for (auto page_id : page_ids) {
+      auto guard = bpm->FetchPageWrite(page_id);
+      ASSERT_EQ(std::string("page ") + std::to_string(page_id), std::string(guard.GetData()));
+      guard.GetDataMut();
+    }
+  }
+  bpm->StopBackgroundFlush();
+  bpm->StopBackgroundFlush();
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ScanAccessTest) {
+  const size_t buffer_pool_size = 12;
+  const size_t num_hot_pages = 6;
+  const size_t num_scan_pages = 40;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_hot_pages + num_scan_pages; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  auto is_resident = [&](page_id_t page_id) {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      if (bpm->GetPages()[i].GetPageId() == page_id) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Scenario: the hot pages are accessed often enough to get a finite k-distance.
+  for (size_t round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < num_hot_pages; ++i) {
+      auto guard = bpm->FetchPageRead(page_ids[i]);
+      ASSERT_EQ(std::string("page ") + std::to_string(page_ids[i]), std::string(guard.GetData()));
+    }
+  }
+
+  // Scenario: a scan over many more pages than the pool holds, prefetching ahead of itself, cycles through a small
+  // ring of frames and leaves the hot pages alone.
+  for (size_t i = num_hot_pages; i < page_ids.size(); ++i) {
+    if (i + 1 < page_ids.size()) {
+      bpm->PrefetchPage(page_ids[i + 1]);
+    }
+    auto guard = bpm->FetchPageRead(page_ids[i], AccessType::Scan);
+    ASSERT_EQ(std::string("page ") + std::to_string(page_ids[i]), std::string(guard.GetData()));
+  }
+  for (size_t i = 0; i < num_hot_pages; ++i) {
+    EXPECT_TRUE(is_resident(page_ids[i]));
+  }
+
+  // Scenario: a prefetched page is resident but not pinned, and prefetching it again does nothing.
+  page_id_t cold_page_id = page_ids[num_hot_pages];
+  ASSERT_FALSE(is_resident(cold_page_id));
+  EXPECT_TRUE(bpm->PrefetchPage(cold_page_id));
+  EXPECT_FALSE(bpm->PrefetchPage(cold_page_id));
+  EXPECT_TRUE(is_resident(cold_page_id));
+  EXPECT_FALSE(bpm->UnpinPage(cold_page_id, false));
+  {
+    auto guard = bpm->FetchPageRead(cold_page_id);
+    EXPECT_EQ(std::string("page ") + std::to_string(cold_page_id), std::string(guard.GetData()));
+  }
+  EXPECT_FALSE(bpm->PrefetchPage(INVALID_PAGE_ID));
+  EXPECT_FALSE(bpm->PrefetchPage(page_ids.back() + 1));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageSizeTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = 16;
+  const int page_size = 4 * BUSTUB_PAGE_SIZE;
+
+  EXPECT_THROW(SetPageSize(BUSTUB_PAGE_SIZE + 1), Exception);
+  EXPECT_THROW(SetPageSize(2 * BUSTUB_MAX_PAGE_SIZE), Exception);
+  SetPageSize(page_size);
+
+  {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+    // Scenario: every byte of a larger page survives eviction and reload.
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < num_pages; ++i) {
+      page_id_t page_id;
+      auto guard = bpm->NewPageGuarded(&page_id);
+      memset(guard.GetDataMut(), 'a' + i, page_size);
+      page_ids.push_back(page_id);
+    }
+    for (size_t i = 0; i < num_pages; ++i) {
+      auto guard = bpm->FetchPageRead(page_ids[i]);
+      EXPECT_EQ('a' + static_cast<int>(i), guard.GetData()[0]);
+      EXPECT_EQ('a' + static_cast<int>(i), guard.GetData()[page_size - 1]);
+    }
+  }
+
+  SetPageSize(BUSTUB_PAGE_SIZE);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentFetchTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t num_pages = 64;
+  const size_t num_threads = 4;
+  const size_t num_rounds = 2000;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: threads hammer a few hot pages, which are pinned without the shard latch, while cold pages keep evicting
+  // frames. Every fetch sees the right page.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      for (size_t round = 0; round < num_rounds; ++round) {
+        size_t i = round % 4 == 0 ? rng() % num_pages : rng() % 4;
+        auto guard = bpm->FetchPageRead(page_ids[i]);
+        ASSERT_NE(nullptr, guard.GetData());
+        ASSERT_EQ(std::string("page ") + std::to_string(page_ids[i]), std::string(guard.GetData()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->DeletePage(page_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, StatsTest) {
+  const size_t buffer_pool_size = 3;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_ids[4];
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+  // Creating pages neither hits nor misses.
+  EXPECT_EQ(0, bpm->GetStats().hits_ + bpm->GetStats().misses_);
+
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(1, bpm->GetStats().hits_);
+
+  // The pool is full of dirty pages, so the new page pushes one of them out.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[3]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[3], false));
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.evictions_);
+  EXPECT_EQ(1, stats.dirty_evictions_);
+  EXPECT_EQ(1, stats.writes_);
+  EXPECT_EQ(1, stats.write_latency_.count_);
+
+  // Page 0 has been accessed twice, so page 1 was the victim. Reading it back evicts page 2, the next oldest.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[1], false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(2, stats.hits_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_DOUBLE_EQ(2.0 / 3, stats.HitRatio());
+  EXPECT_EQ(1, stats.reads_);
+  EXPECT_EQ(1, stats.read_latency_.count_);
+  EXPECT_EQ(2, stats.evictions_);
+  EXPECT_EQ(2, stats.dirty_evictions_);
+
+  bpm->FlushAllPages();
+  stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.flushes_);
+  EXPECT_EQ(stats.dirty_evictions_ + buffer_pool_size, stats.writes_);
+  EXPECT_EQ(stats.hits_, bpm->GetShardStats(0).hits_);
+
+  bpm->ResetStats();
+  stats = bpm->GetStats();
+  EXPECT_EQ(0, stats.hits_ + stats.misses_ + stats.evictions_ + stats.writes_ + stats.read_latency_.count_);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FetchPagesTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t num_pages = 20;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  bpm->ResetStats();
+
+  // Pages 10..19 are resident, 0..7 have to be read back. Page 12 is asked for twice and pinned twice.
+  std::vector<page_id_t> batch{12, 0, 1, 2, 3, 12, 4, 5, 6, 7};
+  auto pages = bpm->FetchPages(batch);
+  ASSERT_EQ(batch.size(), pages.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    ASSERT_NE(nullptr, pages[i]);
+    EXPECT_EQ(batch[i], pages[i]->GetPageId());
+    EXPECT_EQ(std::string("page ") + std::to_string(batch[i]), std::string(pages[i]->GetData()));
+  }
+  EXPECT_EQ(2, pages[0]->GetPinCount());
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(8, stats.misses_);
+  EXPECT_EQ(8, stats.reads_);
+
+  // Every frame is pinned now, so nothing else can be fetched.
+  auto more = bpm->FetchPages({0, 8});
+  EXPECT_NE(nullptr, more[0]);
+  EXPECT_EQ(nullptr, more[1]);
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  for (page_id_t page_id : batch) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  {
+    auto guards = bpm->FetchPagesRead({8, 9, 10, 11});
+    for (size_t i = 0; i < guards.size(); ++i) {
+      ASSERT_TRUE(guards[i].IsValid());
+      EXPECT_EQ(std::string("page ") + std::to_string(8 + i), std::string(guards[i].GetData()));
+    }
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+}
+
+/** An in-memory disk manager whose reads and writes can be made to fail. */
+class FailingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPageAsync(page_id_t page_id, char *page_data, Callback callback) override {
+    if (fail_reads_) {
+      callback(false);
+      return;
+    }
+    DiskManager::ReadPageAsync(page_id, page_data, std::move(callback));
+  }
+
+  void ReadPagesAsync(page_id_t first_page_id, std::vector<char *> page_data, Callback callback) override {
+    if (fail_reads_) {
+      callback(false);
+      return;
+    }
+    DiskManager::ReadPagesAsync(first_page_id, std::move(page_data), std::move(callback));
+  }
+
+  void WritePageAsync(page_id_t page_id, const char *page_data, Callback callback) override {
+    if (fail_writes_) {
+      callback(false);
+      return;
+    }
+    DiskManager::WritePageAsync(page_id, page_data, std::move(callback));
+  }
+
+  std::atomic<bool> fail_reads_{false};
+  std::atomic<bool> fail_writes_{false};
+};
+
+// Pages that could not be read are not fetched, and victims that could not be written stay in the pool.
+TEST(BufferPoolManagerTest, DiskFailureTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = 8;
+  auto disk_manager = std::make_unique<FailingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2);
+
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+  bpm->FlushAllPages();
+
+  // Pages 4..7 are resident, the others can't be read.
+  disk_manager->fail_reads_ = true;
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+  auto pages = bpm->FetchPages({1, 2});
+  EXPECT_EQ(nullptr, pages[0]);
+  EXPECT_EQ(nullptr, pages[1]);
+  EXPECT_TRUE(bpm->PrefetchPage(3));
+  EXPECT_EQ(nullptr, bpm->FetchPage(3));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+
+  // Once the disk is back, every page reads fine, including the resident ones that lost their frame.
+  disk_manager->fail_reads_ = false;
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_pages); ++page_id) {
+    auto guard = bpm->FetchPageRead(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_EQ(std::string("page ") + std::to_string(page_id), std::string(guard.GetData()));
+  }
+
+  // Victims that can't be written keep their frame and their changes.
+  for (page_id_t page_id = 4; page_id < 8; ++page_id) {
+    auto guard = bpm->FetchPageWrite(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "changed %d", page_id);
+  }
+  disk_manager->fail_writes_ = true;
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(nullptr, bpm->FetchPages({1})[0]);
+  EXPECT_FALSE(bpm->FlushPage(0));
+  bpm->FlushAllPages();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+    EXPECT_TRUE(bpm->GetPages()[i].IsDirty());
+  }
+  disk_manager->fail_writes_ = false;
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_pages); ++page_id) {
+    auto guard = bpm->FetchPageRead(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_EQ(std::string(page_id < 4 ? "page " : "changed ") + std::to_string(page_id), std::string(guard.GetData()));
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats_test.cpp
+//
+// Identification: test/buffer/buffer_pool_stats_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <chrono>  // NOLINT
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, HistogramTest) {
+  EXPECT_EQ(0, LatencyHistogram::BucketOf(0));
+  EXPECT_EQ(1, LatencyHistogram::BucketOf(1));
+  EXPECT_EQ(2, LatencyHistogram::BucketOf(2));
+  EXPECT_EQ(2, LatencyHistogram::BucketOf(3));
+  EXPECT_EQ(11, LatencyHistogram::BucketOf(1024));
+  EXPECT_EQ(LatencyHistogram::NUM_BUCKETS - 1, LatencyHistogram::BucketOf(UINT64_MAX));
+
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.GetSnapshot().PercentileMicros(99));
+  // 98 fast operations and 2 slow ones.
+  for (int i = 0; i < 98; i++) {
+    histogram.Record(std::chrono::microseconds(3));
+  }
+  histogram.Record(std::chrono::milliseconds(1));
+  histogram.Record(std::chrono::milliseconds(1));
+
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(100, snapshot.count_);
+  EXPECT_EQ(4, snapshot.PercentileMicros(50));
+  EXPECT_EQ(4, snapshot.PercentileMicros(98));
+  EXPECT_EQ(1024, snapshot.PercentileMicros(99));
+  EXPECT_DOUBLE_EQ((98 * 3 + 2 * 1000) / 100.0, snapshot.MeanMicros());
+
+  auto sum = snapshot;
+  sum += snapshot;
+  EXPECT_EQ(200, sum.count_);
+  EXPECT_EQ(4, sum.PercentileMicros(50));
+
+  histogram.Reset();
+  EXPECT_EQ(0, histogram.GetSnapshot().count_);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, JsonTest) {
+  BufferPoolCounters counters;
+  BufferPoolCounters::Add(counters.hits_, 3);
+  BufferPoolCounters::Add(counters.misses_);
+  counters.read_latency_.Record(std::chrono::microseconds(5));
+
+  auto stats = counters.GetSnapshot();
+  EXPECT_DOUBLE_EQ(0.75, stats.HitRatio());
+  auto json = stats.ToJson();
+  EXPECT_NE(std::string::npos, json.find(R"("hits": 3, "misses": 1, "hit_ratio": 0.7500)"));
+  EXPECT_NE(std::string::npos, json.find(R"("read_latency": {"count": 1, "mean_us": 5.000, "p50_us": 8, "p99_us": 8)"));
+
+  counters.Reset();
+  EXPECT_EQ(0, counters.GetSnapshot().hits_);
+  EXPECT_EQ(0, counters.GetSnapshot().read_latency_.count_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, LayoutTest) {
+  const size_t num_frames = 37;
+  FrameArena arena(num_frames, BUSTUB_PAGE_SIZE);
+  Page *frames = arena.GetFrames();
+
+  EXPECT_EQ(0, arena.GetMappingPageSize() % BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frames[0].GetData()) % BUSTUB_PAGE_SIZE);
+  for (size_t i = 0; i < num_frames; i++) {
+    // The data of the frames is contiguous and starts out zeroed.
+    EXPECT_EQ(frames[0].GetData() + i * BUSTUB_PAGE_SIZE, frames[i].GetData());
+    EXPECT_EQ(INVALID_PAGE_ID, frames[i].GetPageId());
+    EXPECT_EQ(0, frames[i].GetData()[0]);
+    EXPECT_EQ(0, frames[i].GetData()[BUSTUB_PAGE_SIZE - 1]);
+    memset(frames[i].GetData(), static_cast<int>(i), BUSTUB_PAGE_SIZE);
+  }
+  for (size_t i = 0; i < num_frames; i++) {
+    EXPECT_EQ(static_cast<char>(i), frames[i].GetData()[BUSTUB_PAGE_SIZE - 1]);
+  }
+
+  EXPECT_GE(FrameArena::NumNumaNodes(), 1);
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BindToNodeTest) {
+  const size_t num_frames = 1024;
+  FrameArena arena(num_frames, BUSTUB_PAGE_SIZE);
+
+  // Node 0 always exists, binding to it works unless the range is smaller than a page of the mapping.
+  if (arena.GetMappingPageSize() <= num_frames * BUSTUB_PAGE_SIZE) {
+    EXPECT_TRUE(arena.BindToNode(0, num_frames, 0));
+  }
+  EXPECT_FALSE(arena.BindToNode(0, num_frames, -1));
+  EXPECT_FALSE(arena.BindToNode(0, 0, 0));
+  memset(arena.GetFrames()[0].GetData(), 1, BUSTUB_PAGE_SIZE);
+}
+
+}  // namespace bustub
@@ -95,4 +95,80 @@ TEST(LRUKReplacerTest, SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, VictimOrderTest) {
+  LRUKReplacer lru_replacer(4, 3);
+
+  // Timestamps 1..9. Frames 0 and 1 reach k accesses, frames 2 and 3 don't.
+  for (frame_id_t fid : {0, 1, 2, 0, 0, 1, 1, 2, 3}) {
+    lru_replacer.RecordAccess(fid);
+  }
+  // The 4th access of frame 0 pushes its k-th most recent access from 1 to 4, behind frame 1 (2).
+  lru_replacer.RecordAccess(0);
+  for (frame_id_t fid = 0; fid < 4; fid++) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+  ASSERT_EQ(4, lru_replacer.Size());
+
+  // +inf frames by earliest access first, then the rest by k-th most recent access.
+  ASSERT_EQ((std::vector<frame_id_t>{2, 3, 1, 0}), lru_replacer.PeekVictims(10));
+  ASSERT_EQ((std::vector<frame_id_t>{2, 3}), lru_replacer.PeekVictims(2));
+  ASSERT_EQ(4, lru_replacer.Size());
+
+  // A filtered eviction takes the best victim that passes the filter.
+  int value;
+  ASSERT_TRUE(lru_replacer.Evict(&value, [](frame_id_t fid) { return fid % 2 == 1; }));
+  ASSERT_EQ(3, value);
+  ASSERT_FALSE(lru_replacer.Evict(&value, [](frame_id_t fid) { return fid == 3; }));
+  ASSERT_EQ(3, lru_replacer.Size());
+  // It gives up after max_candidates victims: frame 0 is the third one.
+  ASSERT_FALSE(lru_replacer.Evict(&value, [](frame_id_t fid) { return fid == 0; }, 2));
+  ASSERT_EQ(3, lru_replacer.Size());
+
+  // Frames that are not evictable keep their place once they become evictable again.
+  lru_replacer.SetEvictable(2, false);
+  ASSERT_EQ((std::vector<frame_id_t>{1, 0}), lru_replacer.PeekVictims(10));
+  lru_replacer.SetEvictable(2, true);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  lru_replacer.Remove(1);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_FALSE(lru_replacer.Evict(&value));
+  ASSERT_EQ(0, lru_replacer.Size());
+}
+TEST(LRUKReplacerTest, ScanRingTest) {
+  LRUKReplacer lru_replacer(8, 2, 2);
+  int value;
+
+  // Frames 0 and 1 are hot, frames 2..5 are brought in by a scan.
+  for (frame_id_t fid : {0, 1, 0, 1}) {
+    lru_replacer.RecordAccess(fid);
+  }
+  for (frame_id_t fid = 2; fid < 6; fid++) {
+    lru_replacer.RecordAccess(fid, AccessType::Scan);
+  }
+  // A scan touching a hot frame does not change its history.
+  lru_replacer.RecordAccess(0, AccessType::Scan);
+  for (frame_id_t fid = 0; fid < 6; fid++) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+
+  // The ring is full, so the scan recycles its own frames, oldest first, before touching the hot ones.
+  ASSERT_EQ((std::vector<frame_id_t>{2, 3, 4, 5, 0, 1}), lru_replacer.PeekVictims(10));
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+
+  // Below the ring size, scan frames compete with other +inf frames by timestamp.
+  lru_replacer.RecordAccess(6);
+  lru_replacer.SetEvictable(6, true);
+  lru_replacer.SetEvictable(5, false);
+  ASSERT_EQ((std::vector<frame_id_t>{4, 6, 0, 1}), lru_replacer.PeekVictims(10));
+
+  // A regular access takes a frame out of the ring.
+  lru_replacer.RecordAccess(4);
+  ASSERT_EQ((std::vector<frame_id_t>{6, 4, 0, 1}), lru_replacer.PeekVictims(10));
+}
 }  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  frame_id_t frame_id;
+
+  page_table.Insert(10, 0);
+  page_table.Insert(11, 1);
+  page_table.Insert(12, 2);
+  ASSERT_EQ(3, page_table.Size());
+  ASSERT_TRUE(page_table.Find(11, &frame_id));
+  ASSERT_EQ(1, frame_id);
+  ASSERT_FALSE(page_table.Find(13, &frame_id));
+
+  // Inserting an existing page replaces its mapping.
+  page_table.Insert(11, 3);
+  ASSERT_EQ(3, page_table.Size());
+  ASSERT_TRUE(page_table.Find(11, &frame_id));
+  ASSERT_EQ(3, frame_id);
+
+  ASSERT_TRUE(page_table.Erase(10));
+  ASSERT_FALSE(page_table.Erase(10));
+  ASSERT_FALSE(page_table.Find(10, &frame_id));
+  ASSERT_TRUE(page_table.Find(12, &frame_id));
+  ASSERT_EQ(2, frame_id);
+  ASSERT_EQ(2, page_table.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, ChurnTest) {
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  std::map<page_id_t, frame_id_t> expected;
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 4 * num_frames);
+
+  // Keep the table full and churn it, so that erasing has to shift entries of long clusters.
+  for (int round = 0; round < 20000; round++) {
+    page_id_t page_id = page_dist(rng);
+    if (expected.count(page_id) != 0) {
+      ASSERT_TRUE(page_table.Erase(page_id));
+      expected.erase(page_id);
+    } else if (expected.size() < num_frames) {
+      page_table.Insert(page_id, round % num_frames);
+      expected[page_id] = round % num_frames;
+    }
+  }
+
+  ASSERT_EQ(expected.size(), page_table.Size());
+  for (page_id_t page_id = 0; page_id <= static_cast<page_id_t>(4 * num_frames); page_id++) {
+    frame_id_t frame_id;
+    bool found = page_table.Find(page_id, &frame_id);
+    ASSERT_EQ(expected.count(page_id) != 0, found);
+    if (found) {
+      ASSERT_EQ(expected[page_id], frame_id);
+    }
+  }
+  size_t visited = 0;
+  page_table.ForEach([&](page_id_t page_id, frame_id_t frame_id) {
+    ASSERT_EQ(expected[page_id], frame_id);
+    visited++;
+  });
+  ASSERT_EQ(expected.size(), visited);
+}
+
+}  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using BulkLoadInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using BulkLoadLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+auto MakeEntry(int64_t key, int32_t slot) -> std::pair<GenericKey<8>, RID> {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return {index_key, RID(static_cast<int32_t>(key >> 32), slot)};
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  BulkLoadTree tree("foo_pk", page_id, bpm.get(), comparator, 8, 6);
+
+  // Shuffled keys 1..1000, with a duplicate of every tenth key that must lose to the original.
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 1; key <= 1000; key++) {
+    entries.push_back(MakeEntry(key, key));
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+  for (int64_t key = 10; key <= 1000; key += 10) {
+    entries.push_back(MakeEntry(key, -1));
+  }
+  ASSERT_TRUE(tree.BulkLoad(&entries, 0.75));
+  ASSERT_EQ(entries.size(), 1000);
+
+  // A second load into a non-empty tree is refused.
+  std::vector<std::pair<GenericKey<8>, RID>> more = {MakeEntry(2000, 2000)};
+  ASSERT_FALSE(tree.BulkLoad(&more));
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++current_key) {
+    ASSERT_EQ((*iterator).second.GetSlotNum(), current_key);
+  }
+  ASSERT_EQ(current_key, 1001);
+
+  // Leaves hold 7 entries at most; at 0.75 they are packed with 5, all 1000 keys in 200 leaves.
+  size_t num_leaves = 0;
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard = bpm->FetchPageRead(guard.As<BulkLoadInternalPage>()->ValueAt(0));
+    }
+    page_id_t leaf_page_id = guard.PageId();
+    while (leaf_page_id != INVALID_PAGE_ID) {
+      guard = bpm->FetchPageRead(leaf_page_id);
+      auto *leaf_page = guard.As<BulkLoadLeafPage>();
+      ASSERT_EQ(leaf_page->GetSize(), 5);
+      leaf_page_id = leaf_page->GetNextPageId();
+      num_leaves++;
+    }
+  }
+  ASSERT_EQ(num_leaves, 200);
+
+  // The loaded tree takes ordinary inserts and removes.
+  GenericKey<8> index_key;
+  for (int64_t key = 1001; key <= 1500; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+  for (int64_t key = 1; key <= 1500; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  std::vector<RID> result;
+  for (int64_t key = 1; key <= 1500; key++) {
+    result.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_EQ(tree.GetValue(index_key, &result), key % 2 == 0);
+    if (key % 2 == 0) {
+      ASSERT_EQ(result[0].GetSlotNum(), key);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, BulkLoadSmallTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  BulkLoadTree tree("foo_pk", page_id, bpm.get(), comparator, 3, 3);
+
+  // Nothing to load leaves the tree empty.
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  ASSERT_TRUE(tree.BulkLoad(&entries));
+  ASSERT_TRUE(tree.IsEmpty());
+
+  // A single leaf becomes the root.
+  entries = {MakeEntry(2, 2), MakeEntry(1, 1)};
+  ASSERT_TRUE(tree.BulkLoad(&entries, 1.0));
+  auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+  ASSERT_TRUE(guard.As<BPlusTreePage>()->IsLeafPage());
+  guard.Drop();
+
+  GenericKey<8> index_key;
+  for (int64_t key = 3; key <= 50; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++current_key) {
+    ASSERT_EQ((*iterator).second.GetSlotNum(), current_key);
+  }
+  ASSERT_EQ(current_key, 51);
+}
+
+}  // namespace bustub
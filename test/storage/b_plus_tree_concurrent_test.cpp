@@ -10,10 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <cstdlib>
 #include <functional>
+#include <random>
 #include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
@@ -448,6 +450,59 @@ TEST(BPlusTreeConcurrentTest, MyMixTest) {
   delete bpm;
 }
 
+TEST(BPlusTreeConcurrentTest, OptimisticMixTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(256, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // Leaves big enough that most writes stay on the optimistic path, small enough that some still split and merge.
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 16, 8);
+
+  // Keys 0 mod 3 stay put, 1 mod 3 get removed, 2 mod 3 get inserted.
+  const int64_t total_keys = 6000;
+  std::vector<int64_t> stable_keys;
+  std::vector<int64_t> remove_keys;
+  std::vector<int64_t> insert_keys;
+  for (int64_t key = 1; key <= total_keys; key++) {
+    (key % 3 == 0 ? stable_keys : key % 3 == 1 ? remove_keys : insert_keys).push_back(key);
+  }
+  std::vector<int64_t> initial_keys = stable_keys;
+  initial_keys.insert(initial_keys.end(), remove_keys.begin(), remove_keys.end());
+  std::shuffle(initial_keys.begin(), initial_keys.end(), std::mt19937(15445));
+  InsertHelperSplit(&tree, initial_keys, 1, 0);
+
+  const int writer_threads = 8;
+  std::vector<std::thread> thread_group;
+  for (int thread_itr = 0; thread_itr < writer_threads; thread_itr++) {
+    thread_group.emplace_back(InsertHelperSplit, &tree, insert_keys, writer_threads, thread_itr);
+    thread_group.emplace_back(DeleteHelperSplit, &tree, remove_keys, writer_threads, thread_itr);
+    thread_group.emplace_back(LookupHelper, &tree, stable_keys, thread_itr, thread_itr);
+  }
+  for (auto &thread : thread_group) {
+    thread.join();
+  }
+
+  std::vector<int64_t> expected = stable_keys;
+  expected.insert(expected.end(), insert_keys.begin(), insert_keys.end());
+  std::sort(expected.begin(), expected.end());
+  size_t size = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++size) {
+    ASSERT_LT(size, expected.size());
+    EXPECT_EQ((*iterator).second.GetSlotNum(), expected[size]);
+  }
+  EXPECT_EQ(size, expected.size());
+  LookupHelper(&tree, expected, 0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_get_values_test.cpp
+//
+// Identification: test/storage/b_plus_tree_get_values_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, GetValuesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+
+  std::vector<GenericKey<8>> keys;
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(keys, &results);
+  ASSERT_TRUE(results.empty());
+
+  // Even keys only. The probes mix hits, misses between keys, keys past either end, and repeats, in random order.
+  std::vector<int64_t> inserted;
+  for (int64_t key = 0; key < 2000; key += 2) {
+    inserted.push_back(key);
+  }
+  std::shuffle(inserted.begin(), inserted.end(), std::mt19937(15445));
+  for (int64_t key : inserted) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+
+  std::vector<int64_t> probes;
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<int64_t> dist(-10, 2010);
+  for (int i = 0; i < 500; i++) {
+    probes.push_back(dist(rng));
+  }
+  probes.push_back(probes.front());
+  for (int64_t probe : probes) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(probe);
+    keys.push_back(index_key);
+  }
+
+  tree.GetValues(keys, &results);
+  ASSERT_EQ(results.size(), probes.size());
+  for (size_t i = 0; i < probes.size(); i++) {
+    if (probes[i] >= 0 && probes[i] < 2000 && probes[i] % 2 == 0) {
+      ASSERT_EQ(results[i], std::vector<RID>{RID(0, probes[i])}) << probes[i];
+    } else {
+      ASSERT_TRUE(results[i].empty()) << probes[i];
+    }
+  }
+}
+
+}  // namespace bustub
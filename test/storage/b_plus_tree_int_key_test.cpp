@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_int_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_int_key_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/int_key_search.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, IntKeyLowerBoundTest) {
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+  // Strides of an internal and a leaf page of GenericKey<8>; int32 keys padded with garbage the shift must drop.
+  for (size_t stride : {12, 16}) {
+    for (int n = 0; n <= 70; n++) {
+      std::vector<int32_t> keys(n);
+      for (auto &key : keys) {
+        key = dist(rng);
+      }
+      std::sort(keys.begin(), keys.end());
+      std::vector<char> node(stride * n + 8);
+      for (int i = 0; i < n; i++) {
+        memcpy(node.data() + stride * i, &keys[i], sizeof(int32_t));
+        memset(node.data() + stride * i + sizeof(int32_t), 0xff, stride - sizeof(int32_t));
+      }
+      for (int32_t probe = -1002; probe <= 1002; probe += 7) {
+        auto expected = std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin();
+        auto shifted = static_cast<int64_t>(static_cast<uint64_t>(static_cast<uint32_t>(probe)) << 32);
+        ASSERT_EQ(IntKeyLowerBound(node.data(), stride, n, shifted, 32), expected);
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, IntegerComparatorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericIntegerComparator<8> comparator(key_schema.get());
+  ASSERT_EQ(comparator.RawShift(), 0);
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 20, 20);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = -500; key < 500; key++) {
+    keys.push_back(key * 3);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key))));
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = -1501; key < 1499; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_EQ(tree.GetValue(index_key, &rids), key % 3 == 0);
+    if (key % 3 == 0) {
+      ASSERT_EQ(rids[0].GetSlotNum(), static_cast<uint32_t>(key));
+    }
+  }
+
+  int64_t current_key = -1500;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, current_key += 3) {
+    ASSERT_EQ((*iterator).first.ToString(), current_key);
+  }
+  ASSERT_EQ(current_key, 1500);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, IntegerComparatorLayoutTest) {
+  auto integer_schema = ParseCreateStatement("a integer");
+  GenericIntegerComparator<8> integer_comparator(integer_schema.get());
+  ASSERT_EQ(integer_comparator.RawShift(), 32);
+
+  auto pair_schema = ParseCreateStatement("a integer,b integer");
+  GenericIntegerComparator<8> pair_comparator(pair_schema.get());
+  GenericComparator<8> generic_comparator(pair_schema.get());
+  ASSERT_EQ(pair_comparator.RawShift(), -1);
+
+  // Two INTEGER columns order like the Value comparison, the first column first.
+  std::vector<int32_t> values = {INT32_MIN + 1, -7, -1, 0, 1, 7, INT32_MAX};
+  GenericKey<8> lhs;
+  GenericKey<8> rhs;
+  for (auto a1 : values) {
+    for (auto b1 : values) {
+      for (auto a2 : values) {
+        for (auto b2 : values) {
+          memcpy(lhs.data_, &a1, sizeof(a1));
+          memcpy(lhs.data_ + sizeof(a1), &b1, sizeof(b1));
+          memcpy(rhs.data_, &a2, sizeof(a2));
+          memcpy(rhs.data_ + sizeof(a2), &b2, sizeof(b2));
+          ASSERT_EQ(pair_comparator(lhs, rhs), generic_comparator(lhs, rhs));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace bustub
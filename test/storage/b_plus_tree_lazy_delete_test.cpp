@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_lazy_delete_test.cpp
+//
+// Identification: test/storage/b_plus_tree_lazy_delete_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+using LazyTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using LazyInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using LazyLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+/** Count the pages under page_id, and how many of them other than the root are below their min size. */
+void CountPages(BufferPoolManager *bpm, page_id_t page_id, bool is_root, int *pages, int *underfull) {
+  auto guard = bpm->FetchPageRead(page_id);
+  const auto *page = guard.As<BPlusTreePage>();
+  (*pages)++;
+  if (!is_root && page->GetSize() < page->GetMinSize()) {
+    (*underfull)++;
+  }
+  if (page->IsLeafPage()) {
+    return;
+  }
+  const auto *internal_page = guard.As<LazyInternalPage>();
+  for (int i = 0; i < internal_page->GetSize(); i++) {
+    CountPages(bpm, internal_page->ValueAt(i), false, pages, underfull);
+  }
+}
+
+/** The keys of the tree, read from the leaf chain. */
+auto TreeKeys(LazyTree *tree) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (auto iterator = tree->Begin(); !iterator.IsEnd(); ++iterator) {
+    keys.push_back((*iterator).first.ToString());
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, LazyDeleteCompactTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  LazyTree tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+  tree.SetLazyDelete(true);
+
+  // A queue: keys go in at the tail and come out at the head, with every fourth key left behind.
+  std::vector<int64_t> expected;
+  int64_t head = 0;
+  int64_t tail = 0;
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 500; i++, tail++) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(tail);
+      tree.Insert(index_key, RID(0, tail));
+    }
+    for (; head < tail - 100; head++) {
+      if (head % 4 == 0) {
+        expected.push_back(head);
+        continue;
+      }
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(head);
+      tree.Remove(index_key, nullptr);
+    }
+  }
+  for (int64_t key = head; key < tail; key++) {
+    expected.push_back(key);
+  }
+  ASSERT_EQ(TreeKeys(&tree), expected);
+
+  int pages_before = 0;
+  int underfull_before = 0;
+  CountPages(bpm.get(), tree.GetRootPageId(), true, &pages_before, &underfull_before);
+  ASSERT_GT(underfull_before, 0);
+
+  int freed = 0;
+  for (int pass = tree.Compact(); pass > 0; pass = tree.Compact()) {
+    freed += pass;
+  }
+  int pages_after = 0;
+  int underfull_after = 0;
+  CountPages(bpm.get(), tree.GetRootPageId(), true, &pages_after, &underfull_after);
+  ASSERT_EQ(underfull_after, 0);
+  ASSERT_EQ(pages_after, pages_before - freed);
+  ASSERT_EQ(TreeKeys(&tree), expected);
+
+  // The leaves are still linked both ways.
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard = bpm->FetchPageRead(guard.As<LazyInternalPage>()->ValueAt(0));
+    }
+    page_id_t prev_page_id = INVALID_PAGE_ID;
+    page_id_t leaf_page_id = guard.PageId();
+    while (leaf_page_id != INVALID_PAGE_ID) {
+      guard = bpm->FetchPageRead(leaf_page_id);
+      ASSERT_EQ(guard.As<LazyLeafPage>()->GetPrevPageId(), prev_page_id);
+      prev_page_id = leaf_page_id;
+      leaf_page_id = guard.As<LazyLeafPage>()->GetNextPageId();
+    }
+  }
+
+  // Removing everything still empties the tree.
+  for (int64_t key : expected) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, BackgroundCompactionTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  LazyTree tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+  tree.SetLazyDelete(true, 1);
+  auto old_interval = bplustree_compaction_interval;
+  bplustree_compaction_interval = std::chrono::milliseconds(5);
+  tree.StartBackgroundCompaction();
+
+  // Each writer owns the keys of one residue and keeps the multiples of 8 among them.
+  const int64_t max_key = 4000;
+  std::vector<std::thread> writers;
+  for (int64_t offset = 0; offset < 4; offset++) {
+    writers.emplace_back([&tree, offset, max_key] {
+      for (int round = 0; round < 2; round++) {
+        for (int64_t key = offset; key < max_key; key += 4) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, RID(0, key));
+        }
+        for (int64_t key = offset; key < max_key; key += 4) {
+          if (key % 8 == 0) {
+            continue;
+          }
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key, nullptr);
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  tree.StopBackgroundCompaction();
+  bplustree_compaction_interval = old_interval;
+
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < max_key; key += 8) {
+    expected.push_back(key);
+  }
+  ASSERT_EQ(TreeKeys(&tree), expected);
+  for (int64_t key = 0; key < max_key; key++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    std::vector<RID> rids;
+    ASSERT_EQ(tree.GetValue(index_key, &rids), key % 8 == 0) << key;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_index_test.cpp
+//
+// Identification: test/storage/b_plus_tree_posting_index_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/posting_b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+auto MakePostingIndex(const Schema &table_schema, BufferPoolManager *bpm) -> std::unique_ptr<BPlusTreePostingIndex> {
+  return std::make_unique<BPlusTreePostingIndex>(std::make_unique<IndexMetadata>("idx", "t", &table_schema,
+                                                                                 std::vector<uint32_t>{0}),
+                                                 bpm);
+}
+
+auto PostingKey(BPlusTreePostingIndex *index, int32_t key) -> Tuple {
+  return Tuple({ValueFactory::GetIntegerValue(key)}, index->GetKeySchema());
+}
+
+/** The RIDs the index has for key, which must come back sorted. */
+auto PostingRids(BPlusTreePostingIndex *index, int32_t key) -> std::vector<int64_t> {
+  std::vector<RID> rids;
+  index->ScanKey(PostingKey(index, key), &rids, nullptr);
+  std::vector<int64_t> values;
+  for (const auto &rid : rids) {
+    values.push_back(rid.Get());
+  }
+  return values;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, PostingIndexInsertDeleteTest) {
+  auto table_schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto index = MakePostingIndex(*table_schema, bpm.get());
+
+  // Key k gets k * 40 tuples: short lists stay inline, long ones take a few overflow pages. RIDs far apart encode
+  // into more bytes than neighbours do.
+  std::map<int32_t, std::set<int64_t>> expected;
+  std::vector<std::pair<int32_t, RID>> entries;
+  for (int32_t key = 0; key < 50; key++) {
+    for (int32_t i = 0; i < key * 40; i++) {
+      entries.emplace_back(key, key % 2 == 0 ? RID(i, key) : RID(key, i));
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+  for (const auto &[key, rid] : entries) {
+    ASSERT_TRUE(index->InsertEntry(PostingKey(index.get(), key), rid, nullptr));
+    expected[key].insert(rid.Get());
+  }
+  ASSERT_FALSE(index->InsertEntry(PostingKey(index.get(), entries[0].first), entries[0].second, nullptr));
+  ASSERT_FALSE(index->InsertEntry(PostingKey(index.get(), 49), RID(49, 0), nullptr));
+  for (int32_t key = 0; key < 50; key++) {
+    ASSERT_EQ(PostingRids(index.get(), key), std::vector<int64_t>(expected[key].begin(), expected[key].end())) << key;
+  }
+
+  // A scan of every key sees each key once, with all of its RIDs.
+  size_t scanned = 0;
+  for (auto iter = index->GetRangeIterator(std::nullopt, std::nullopt); !iter.IsEnd(); ++iter) {
+    std::vector<RID> rids;
+    index->GetRids((*iter).first, (*iter).second, &rids);
+    scanned += rids.size();
+  }
+  ASSERT_EQ(scanned, entries.size());
+
+  // Removing two thirds of the tuples frees overflow pages and moves short lists back inline.
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (i % 3 != 0) {
+      const auto &[key, rid] = entries[i];
+      index->DeleteEntry(PostingKey(index.get(), key), rid, nullptr);
+      expected[key].erase(rid.Get());
+    }
+  }
+  index->DeleteEntry(PostingKey(index.get(), 1000), RID(0, 0), nullptr);
+  for (int32_t key = 0; key < 50; key++) {
+    ASSERT_EQ(PostingRids(index.get(), key), std::vector<int64_t>(expected[key].begin(), expected[key].end())) << key;
+  }
+
+  for (size_t i = 0; i < entries.size(); i += 3) {
+    const auto &[key, rid] = entries[i];
+    index->DeleteEntry(PostingKey(index.get(), key), rid, nullptr);
+  }
+  ASSERT_TRUE(index->GetTree()->IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, PostingIndexBulkLoadTest) {
+  auto table_schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto index = MakePostingIndex(*table_schema, bpm.get());
+
+  // A foreign key column: 20000 tuples over 100 keys, in heap order.
+  std::vector<std::pair<IntegerKeyType, RID>> entries;
+  std::vector<Tuple> keys;
+  for (int32_t i = 0; i < 20000; i++) {
+    IntegerKeyType index_key;
+    index_key.SetFromKey(PostingKey(index.get(), i % 100));
+    entries.emplace_back(index_key, RID(i / 50, i % 50));
+  }
+  for (int32_t key = -1; key <= 100; key++) {
+    keys.push_back(PostingKey(index.get(), key));
+  }
+  ASSERT_TRUE(index->BulkLoad(&entries));
+  ASSERT_FALSE(index->BulkLoad(&entries));
+
+  std::vector<std::vector<RID>> results;
+  index->ScanKeys(keys, &results, nullptr);
+  ASSERT_EQ(results.size(), keys.size());
+  ASSERT_TRUE(results.front().empty());
+  ASSERT_TRUE(results.back().empty());
+  for (int32_t key = 0; key < 100; key++) {
+    const auto &rids = results[key + 1];
+    ASSERT_EQ(rids.size(), 200) << key;
+    for (int32_t j = 0; j < 200; j++) {
+      int32_t i = j * 100 + key;
+      ASSERT_EQ(rids[j], RID(i / 50, i % 50)) << key;
+    }
+  }
+
+  // Appending to a long list keeps it in RID order.
+  ASSERT_TRUE(index->InsertEntry(PostingKey(index.get(), 5), RID(1000, 0), nullptr));
+  ASSERT_TRUE(index->InsertEntry(PostingKey(index.get(), 5), RID(0, 49), nullptr));
+  auto rids = PostingRids(index.get(), 5);
+  ASSERT_EQ(rids.size(), 202);
+  ASSERT_TRUE(std::is_sorted(rids.begin(), rids.end()));
+  ASSERT_EQ(rids.back(), RID(1000, 0).Get());
+}
+
+}  // namespace bustub
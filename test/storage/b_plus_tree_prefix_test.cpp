@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_prefix_test.cpp
+//
+// Identification: test/storage/b_plus_tree_prefix_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/prefix_b_plus_tree.h"
+#include "storage/index/prefix_b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+/** A wide composite-style key: a long shared prefix, then a number. */
+auto WideKey(int64_t n) -> std::string {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%010ld", n);
+  return std::string("tenant-0001/region-eu-west/customer/") + buf;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, PrefixTreeInsertRemoveTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  PrefixBPlusTree tree("foo_pk", page_id, bpm.get());
+
+  std::map<std::string, RID> expected;
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<int64_t> dist(0, 4999);
+  for (int i = 0; i < 20000; i++) {
+    int64_t n = dist(rng);
+    // Mix in short keys sorting before and after the wide ones, so the prefixes have to shrink.
+    std::string key = n % 7 == 0 ? std::to_string(n) : n % 11 == 0 ? "zz" + std::to_string(n) : WideKey(n);
+    if (i % 3 == 2) {
+      tree.Remove(key);
+      expected.erase(key);
+    } else {
+      RID rid(static_cast<int32_t>(n), i);
+      ASSERT_EQ(tree.Insert(key, rid), expected.emplace(key, rid).second);
+    }
+  }
+
+  for (const auto &[key, rid] : expected) {
+    std::vector<RID> rids;
+    ASSERT_TRUE(tree.GetValue(key, &rids));
+    ASSERT_EQ(rids[0], rid);
+  }
+  std::vector<RID> rids;
+  ASSERT_FALSE(tree.GetValue(WideKey(5000), &rids));
+
+  auto it = expected.begin();
+  for (auto iterator = tree.Begin(); !iterator.IsEnd(); ++iterator, ++it) {
+    ASSERT_NE(it, expected.end());
+    ASSERT_EQ((*iterator).first, it->first);
+  }
+  ASSERT_EQ(it, expected.end());
+
+  auto from = expected.lower_bound(WideKey(2500));
+  auto iterator = tree.Begin(WideKey(2500));
+  ASSERT_FALSE(iterator.IsEnd());
+  ASSERT_EQ((*iterator).first, from->first);
+
+  ASSERT_FALSE(tree.Insert(std::string(PrefixBPlusTree::MaxKeySize() + 1, 'x'), RID()));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, PrefixTreeFanoutTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t prefix_page_id;
+  auto prefix_header = bpm->NewPageGuarded(&prefix_page_id);
+  PrefixBPlusTree prefix_tree("prefix", prefix_page_id, bpm.get());
+
+  auto key_schema = ParseCreateStatement("a varchar(64)");
+  GenericComparator<64> comparator(key_schema.get());
+  page_id_t fixed_page_id;
+  auto fixed_header = bpm->NewPageGuarded(&fixed_page_id);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> fixed_tree("fixed", fixed_page_id, bpm.get(), comparator);
+
+  std::vector<int64_t> numbers(20000);
+  for (size_t i = 0; i < numbers.size(); i++) {
+    numbers[i] = i;
+  }
+  std::shuffle(numbers.begin(), numbers.end(), std::mt19937(15445));
+  for (auto n : numbers) {
+    std::string key = WideKey(n);
+    ASSERT_TRUE(prefix_tree.Insert(key, RID(0, n)));
+    GenericKey<64> index_key;
+    index_key.SetFromKey(Tuple({Value(TypeId::VARCHAR, key)}, key_schema.get()));
+    ASSERT_TRUE(fixed_tree.Insert(index_key, RID(0, n)));
+  }
+
+  int fixed_height = 0;
+  {
+    auto guard = bpm->FetchPageRead(fixed_tree.GetRootPageId());
+    fixed_height++;
+    while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard = bpm->FetchPageRead(
+          guard.As<BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>>()->ValueAt(0));
+      fixed_height++;
+    }
+  }
+  // 46-byte keys share a 40-byte prefix: the fixed-size tree stores all 64 bytes of each.
+  ASSERT_LT(prefix_tree.GetHeight(), fixed_height);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, PrefixIndexKeyEncodingTest) {
+  auto key_schema = ParseCreateStatement("a integer,b varchar(16),c double");
+  auto encode = [&](const Value &a, const std::string &b, double c) {
+    return BPlusTreePrefixIndex::EncodeKey(
+        Tuple({a, Value(TypeId::VARCHAR, b), Value(TypeId::DECIMAL, c)}, key_schema.get()), *key_schema);
+  };
+  auto null_integer = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+
+  // Listed in ascending order; the encodings must sort the same way.
+  std::vector<std::string> keys = {
+      encode(null_integer, "a", 0),         encode(Value(TypeId::INTEGER, -5), "", 0),
+      encode(Value(TypeId::INTEGER, -5), "a", -2.5), encode(Value(TypeId::INTEGER, -5), "a", -1),
+      encode(Value(TypeId::INTEGER, -5), "a", 3),    encode(Value(TypeId::INTEGER, -5), "ab", -100),
+      encode(Value(TypeId::INTEGER, -5), "b", 0),    encode(Value(TypeId::INTEGER, 0), "", 0),
+      encode(Value(TypeId::INTEGER, 7), "", 0),      encode(Value(TypeId::INTEGER, 300), "", 0),
+  };
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  ASSERT_EQ(std::adjacent_find(keys.begin(), keys.end()), keys.end());
+}
+
+}  // namespace bustub
@@ -0,0 +1,208 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_range_test.cpp
+//
+// Identification: test/storage/b_plus_tree_range_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+using RangeTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using RangeInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using RangeLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+using RangeBound = std::optional<IndexKeyBound<GenericKey<8>>>;
+
+auto MakeBound(int64_t key, bool inclusive) -> RangeBound {
+  IndexKeyBound<GenericKey<8>> bound;
+  bound.key_.SetFromInteger(key);
+  bound.inclusive_ = inclusive;
+  return bound;
+}
+
+/** Run a range scan to its end, forward or backward, and collect the keys. */
+auto ScanRange(RangeTree *tree, const RangeBound &lower, const RangeBound &upper, bool reverse)
+    -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (auto iterator = tree->Range(lower, upper, reverse); !iterator.IsEnd();) {
+    keys.push_back((*iterator).first.ToString());
+    if (reverse) {
+      --iterator;
+    } else {
+      ++iterator;
+    }
+  }
+  return keys;
+}
+
+/** The keys of expected within the bounds, in the order a scan returns them. */
+auto ExpectedRange(const std::set<int64_t> &expected, std::optional<std::pair<int64_t, bool>> lower,
+                   std::optional<std::pair<int64_t, bool>> upper, bool reverse) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (int64_t key : expected) {
+    if (lower.has_value() && (key < lower->first || (key == lower->first && !lower->second))) {
+      continue;
+    }
+    if (upper.has_value() && (key > upper->first || (key == upper->first && !upper->second))) {
+      continue;
+    }
+    keys.push_back(key);
+  }
+  if (reverse) {
+    std::reverse(keys.begin(), keys.end());
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, RangeScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  RangeTree tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+
+  // Even keys only, so that bounds fall both on and between keys. Removes merge and redistribute leaves.
+  std::set<int64_t> expected;
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= 2000; key += 2) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (int64_t key : keys) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+    expected.insert(key);
+  }
+  for (size_t i = 0; i < keys.size(); i += 3) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(keys[i]);
+    tree.Remove(index_key, nullptr);
+    expected.erase(keys[i]);
+  }
+
+  // The leaves are linked both ways.
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard = bpm->FetchPageRead(guard.As<RangeInternalPage>()->ValueAt(0));
+    }
+    page_id_t prev_page_id = INVALID_PAGE_ID;
+    page_id_t leaf_page_id = guard.PageId();
+    while (leaf_page_id != INVALID_PAGE_ID) {
+      guard = bpm->FetchPageRead(leaf_page_id);
+      ASSERT_EQ(guard.As<RangeLeafPage>()->GetPrevPageId(), prev_page_id);
+      prev_page_id = leaf_page_id;
+      leaf_page_id = guard.As<RangeLeafPage>()->GetNextPageId();
+    }
+  }
+
+  for (bool reverse : {false, true}) {
+    ASSERT_EQ(ScanRange(&tree, std::nullopt, std::nullopt, reverse),
+              ExpectedRange(expected, std::nullopt, std::nullopt, reverse));
+    for (int64_t lo : {-5, 0, 99, 100, 101, 1500, 2000, 2001}) {
+      for (int64_t hi : {-1, 2, 100, 199, 200, 1999, 2000, 3000}) {
+        for (bool lo_inclusive : {false, true}) {
+          for (bool hi_inclusive : {false, true}) {
+            ASSERT_EQ(ScanRange(&tree, MakeBound(lo, lo_inclusive), MakeBound(hi, hi_inclusive), reverse),
+                      ExpectedRange(expected, std::make_pair(lo, lo_inclusive), std::make_pair(hi, hi_inclusive),
+                                    reverse))
+                << "lo=" << lo << " hi=" << hi << " reverse=" << reverse;
+          }
+        }
+      }
+      ASSERT_EQ(ScanRange(&tree, MakeBound(lo, true), std::nullopt, reverse),
+                ExpectedRange(expected, std::make_pair(lo, true), std::nullopt, reverse));
+      ASSERT_EQ(ScanRange(&tree, std::nullopt, MakeBound(lo, false), reverse),
+                ExpectedRange(expected, std::nullopt, std::make_pair(lo, false), reverse));
+    }
+  }
+
+  // Stepping back from End() reaches the largest key.
+  auto iterator = tree.End();
+  --iterator;
+  ASSERT_EQ((*iterator).first.ToString(), *expected.rbegin());
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, RangeScanDuringWritesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  RangeTree tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+
+  // Multiples of 4 stay in the tree throughout; the writers split, merge and redistribute the leaves around them.
+  const int64_t max_key = 4000;
+  std::vector<int64_t> stable;
+  for (int64_t key = 0; key < max_key; key += 4) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+    stable.push_back(key);
+  }
+
+  std::vector<std::thread> writers;
+  for (int64_t offset = 1; offset < 4; offset++) {
+    writers.emplace_back([&tree, offset, max_key] {
+      for (int round = 0; round < 3; round++) {
+        for (int64_t key = offset; key < max_key; key += 4) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, RID(0, key));
+        }
+        for (int64_t key = offset; key < max_key; key += 4) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key, nullptr);
+        }
+      }
+    });
+  }
+
+  // Every scan sees each stable key exactly once, in order, whatever the writers do to the leaves under it.
+  for (int scan = 0; scan < 20; scan++) {
+    bool reverse = scan % 2 == 1;
+    auto keys = ScanRange(&tree, MakeBound(100, true), MakeBound(3900, false), reverse);
+    if (reverse) {
+      std::reverse(keys.begin(), keys.end());
+    }
+    ASSERT_TRUE(std::adjacent_find(keys.begin(), keys.end(), std::greater_equal<>()) == keys.end());
+    std::vector<int64_t> seen_stable;
+    std::copy_if(keys.begin(), keys.end(), std::back_inserter(seen_stable), [](int64_t key) { return key % 4 == 0; });
+    ASSERT_EQ(seen_stable, ExpectedRange(std::set<int64_t>(stable.begin(), stable.end()), std::make_pair(100, true),
+                                         std::make_pair(3900, false), false));
+  }
+
+  for (auto &writer : writers) {
+    writer.join();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_root_cache_test.cpp
+//
+// Identification: test/storage/b_plus_tree_root_cache_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+using CacheTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using CacheInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+/** Number of pages on the way from the root to a leaf. */
+auto TreeHeight(BufferPoolManager *bpm, CacheTree *tree) -> int {
+  int height = 1;
+  auto guard = bpm->FetchPageRead(tree->GetRootPageId());
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    guard = bpm->FetchPageRead(guard.As<CacheInternalPage>()->ValueAt(0));
+    height++;
+  }
+  return height;
+}
+
+/** Look up every key in [0, count) and return the number of page fetches it took. */
+auto FetchesToLookUp(BufferPoolManager *bpm, CacheTree *tree, int64_t count) -> uint64_t {
+  bpm->ResetStats();
+  for (int64_t key = 0; key < count; key++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    std::vector<RID> rids;
+    EXPECT_TRUE(tree->GetValue(index_key, &rids)) << key;
+  }
+  auto stats = bpm->GetStats();
+  return stats.hits_ + stats.misses_;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, RootCacheFetchTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(200, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  CacheTree tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+
+  // A lookup fetches the pages on its path and nothing else, also after the root has been replaced.
+  int64_t count = 0;
+  for (int64_t target : {3, 50, 500}) {
+    for (; count < target; count++) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(count);
+      tree.Insert(index_key, RID(0, count));
+    }
+    ASSERT_EQ(FetchesToLookUp(bpm.get(), &tree, count), count * TreeHeight(bpm.get(), &tree));
+  }
+
+  for (; count > 20; count--) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(count - 1);
+    tree.Remove(index_key, nullptr);
+  }
+  ASSERT_EQ(FetchesToLookUp(bpm.get(), &tree, count), count * TreeHeight(bpm.get(), &tree));
+
+  for (; count > 0; count--) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(count - 1);
+    tree.Remove(index_key, nullptr);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(0);
+  ASSERT_FALSE(tree.GetValue(index_key, nullptr));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, RootCacheConcurrentTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(200, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+  CacheTree tree("foo_pk", page_id, bpm.get(), comparator, 3, 3);
+
+  // Readers look for keys that are known to be in the tree while a writer keeps growing or shrinking it at the root.
+  const int64_t max_key = 3000;
+  const int64_t kept = 100;
+  std::atomic<int64_t> present{0};
+  std::atomic<bool> done{false};
+  auto run_readers = [&] {
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 4; reader++) {
+      readers.emplace_back([&, reader] {
+        std::mt19937 gen(reader);
+        while (!done) {
+          int64_t bound = present;
+          if (bound == 0) {
+            continue;
+          }
+          int64_t key = std::uniform_int_distribution<int64_t>(0, bound - 1)(gen);
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          std::vector<RID> rids;
+          ASSERT_TRUE(tree.GetValue(index_key, &rids)) << key;
+          ASSERT_EQ(rids[0].GetSlotNum(), key);
+        }
+      });
+    }
+    return readers;
+  };
+
+  auto readers = run_readers();
+  for (int64_t key = 0; key < max_key; key++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+    present = key + 1;
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  present = kept;
+  done = false;
+  readers = run_readers();
+  for (int64_t key = max_key - 1; key >= kept; key--) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(FetchesToLookUp(bpm.get(), &tree, kept), kept * TreeHeight(bpm.get(), &tree));
+}
+
+}  // namespace bustub
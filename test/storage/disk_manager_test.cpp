@@ -10,11 +10,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_pool_manager.h"
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_async.h"
 
 namespace bustub {
 
@@ -75,4 +82,145 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncReadWritePageTest) {
+  // One extra byte so that buf + 1 is a buffer that is not page aligned.
+  auto buf = std::make_unique<char[]>(BUSTUB_PAGE_SIZE + 1);
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  DiskManagerAsync dm("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  dm.ReadPage(0, buf.get());  // tolerate empty read
+  EXPECT_EQ(0, buf[0]);
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf.get());
+  EXPECT_EQ(std::memcmp(buf.get(), data, BUSTUB_PAGE_SIZE), 0);
+
+  std::memset(buf.get(), 0, BUSTUB_PAGE_SIZE + 1);
+  dm.WritePage(5, data);
+  dm.ReadPage(5, buf.get() + 1);
+  EXPECT_EQ(std::memcmp(buf.get() + 1, data, BUSTUB_PAGE_SIZE), 0);
+  EXPECT_EQ(2, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReadPagesTest) {
+  auto check = [](DiskManager *dm) {
+    char data[BUSTUB_PAGE_SIZE];
+    for (int i = 0; i < 4; i++) {
+      std::memset(data, i + 1, sizeof(data));
+      dm->WritePage(i, data);
+    }
+    // Read a run that goes past the end of the file, into scattered buffers, one of them not page aligned.
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<char *> page_data;
+    for (int i = 0; i < 4; i++) {
+      buffers.emplace_back(std::make_unique<char[]>(BUSTUB_PAGE_SIZE + 1));
+      std::memset(buffers.back().get(), -1, BUSTUB_PAGE_SIZE + 1);
+      page_data.push_back(buffers.back().get() + (i == 1 ? 1 : 0));
+    }
+    std::atomic<bool> done = false;
+    dm->ReadPagesAsync(2, page_data, [&](bool success) {
+      EXPECT_TRUE(success);
+      done = true;
+    });
+    while (!done) {
+      std::this_thread::yield();
+    }
+    for (int i = 0; i < 4; i++) {
+      char expected = i < 2 ? static_cast<char>(i + 3) : 0;
+      EXPECT_EQ(expected, page_data[i][0]);
+      EXPECT_EQ(expected, page_data[i][BUSTUB_PAGE_SIZE - 1]);
+    }
+    dm->ShutDown();
+  };
+
+  {
+    DiskManager dm("test.db");
+    check(&dm);
+  }
+  remove("test.db");
+  {
+    DiskManagerAsync dm("test.db");
+    check(&dm);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncManyInflightTest) {
+  const int num_pages = 256;
+  std::vector<std::unique_ptr<char[]>> pages;
+  for (int i = 0; i < num_pages; i++) {
+    pages.emplace_back(std::make_unique<char[]>(BUSTUB_PAGE_SIZE));
+    std::memset(pages.back().get(), i % 128, BUSTUB_PAGE_SIZE);
+  }
+  DiskManagerAsync dm("test.db", 16);
+
+  std::atomic<int> completed = 0;
+  for (int i = 0; i < num_pages; i++) {
+    dm.WritePageAsync(i, pages[i].get(), [&](bool success) {
+      EXPECT_TRUE(success);
+      completed++;
+    });
+  }
+  while (completed != num_pages) {
+    std::this_thread::yield();
+  }
+
+  completed = 0;
+  for (int i = 0; i < num_pages; i++) {
+    std::memset(pages[i].get(), -1, BUSTUB_PAGE_SIZE);
+    dm.ReadPageAsync(i, pages[i].get(), [&](bool success) {
+      EXPECT_TRUE(success);
+      completed++;
+    });
+  }
+  while (completed != num_pages) {
+    std::this_thread::yield();
+  }
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_EQ(i % 128, pages[i][0]);
+    EXPECT_EQ(i % 128, pages[i][BUSTUB_PAGE_SIZE - 1]);
+  }
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncBufferPoolTest) {
+  DiskManagerAsync dm("test.db");
+  BufferPoolManager bpm(4, &dm, 2, nullptr, 2);
+
+  // Scenario: many more pages than frames, so every fetch writes back a dirty victim and reads a page.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 32; i++) {
+    page_id_t page_id;
+    auto guard = bpm.NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  for (int round = 0; round < 2; round++) {
+    for (auto page_id : page_ids) {
+      auto guard = bpm.FetchPageWrite(page_id);
+      ASSERT_EQ(std::string("page ") + std::to_string(page_id), std::string(guard.GetData()));
+      guard.GetDataMut();
+    }
+  }
+
+  // Scenario: prefetches complete on the disk manager's thread while the pool flushes through it.
+  for (auto page_id : page_ids) {
+    bpm.PrefetchPage(page_id);
+    bpm.FlushAllPages();
+  }
+  for (auto page_id : page_ids) {
+    auto guard = bpm.FetchPageRead(page_id);
+    ASSERT_EQ(std::string("page ") + std::to_string(page_id), std::string(guard.GetData()));
+  }
+
+  dm.ShutDown();
+}
+
 }  // namespace bustub
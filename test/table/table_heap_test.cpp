@@ -0,0 +1,433 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_cursor.h"
+#include "storage/table/table_heap.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+/** Insert the tuples (i, thread_id) for i in [begin, end) from each of thread_count threads. */
+void InsertFromThreads(TableHeap *table, const Schema &schema, int thread_count, int32_t begin, int32_t end) {
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < thread_count; thread_id++) {
+    threads.emplace_back([&, thread_id] {
+      for (int32_t i = begin; i < end; i++) {
+        Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(thread_id)}, &schema);
+        ASSERT_TRUE(table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple).has_value());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+/** @return the (a, b) of every tuple the iterator visits, asserting that each is visited once */
+auto ScanAll(TableIterator iter, const Schema &schema) -> std::set<std::pair<int32_t, int32_t>> {
+  std::set<std::pair<int32_t, int32_t>> tuples;
+  for (; !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    auto inserted =
+        tuples.emplace(tuple.GetValue(&schema, 0).GetAs<int32_t>(), tuple.GetValue(&schema, 1).GetAs<int32_t>());
+    EXPECT_TRUE(inserted.second);
+  }
+  return tuples;
+}
+
+/** @return the number of pages linked into the heap */
+auto CountPages(BufferPoolManager *bpm, const TableHeap &table) -> size_t {
+  size_t count = 0;
+  for (page_id_t page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID; count++) {
+    auto guard = bpm->FetchPageRead(page_id);
+    page_id = guard.As<TablePage>()->GetNextPageId();
+  }
+  return count;
+}
+
+/** @return the a of every tuple the iterator visits that is not deleted, by RID */
+auto ScanLive(TableIterator iter, const Schema &schema) -> std::unordered_map<RID, int32_t> {
+  std::unordered_map<RID, int32_t> tuples;
+  for (; !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (!meta.is_deleted_) {
+      tuples[iter.GetRID()] = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+    }
+  }
+  return tuples;
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  auto schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  InsertFromThreads(&table, *schema, 8, 0, 2000);
+  auto tuples = ScanAll(table.MakeIterator(), *schema);
+  ASSERT_EQ(tuples.size(), 8 * 2000);
+  ASSERT_EQ(ScanAll(table.MakeEagerIterator(), *schema).size(), 8 * 2000);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, IteratorSnapshotTest) {
+  auto schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  // Several pages are half full when the iterator is created. It must not see what is inserted into them after.
+  InsertFromThreads(&table, *schema, 8, 0, 300);
+  auto iter = table.MakeIterator();
+  InsertFromThreads(&table, *schema, 8, 300, 1000);
+  auto tuples = ScanAll(std::move(iter), *schema);
+  ASSERT_EQ(tuples.size(), 8 * 300);
+  for (const auto &[a, b] : tuples) {
+    ASSERT_LT(a, 300);
+  }
+  ASSERT_EQ(ScanAll(table.MakeIterator(), *schema).size(), 8 * 1000);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, CursorTest) {
+  auto schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  // Every third tuple is deleted, and the first 100 are, so that the first page starts with deleted slots.
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 5000; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(0)}, schema.get());
+    rids.push_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  for (int32_t i = 0; i < 5000; i++) {
+    if (i < 100 || i % 3 == 0) {
+      table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+    }
+  }
+
+  // The cursor visits the live tuples the iterator does, in the same order, but fetches each page only once.
+  std::vector<std::pair<RID, int32_t>> expected;
+  bpm->ResetStats();
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (!meta.is_deleted_) {
+      expected.emplace_back(iter.GetRID(), tuple.GetValue(schema.get(), 0).GetAs<int32_t>());
+    }
+  }
+  auto iterator_fetches = bpm->GetStats().hits_ + bpm->GetStats().misses_;
+
+  std::vector<std::pair<RID, int32_t>> visited;
+  bpm->ResetStats();
+  TableCursor cursor(table.MakeIterator());
+  Tuple tuple;
+  while (cursor.Next()) {
+    ASSERT_FALSE(cursor.GetTupleMeta().is_deleted_);
+    cursor.GetTuple(&tuple);
+    ASSERT_EQ(tuple.GetRid(), cursor.GetRID());
+    visited.emplace_back(cursor.GetRID(), tuple.GetValue(schema.get(), 0).GetAs<int32_t>());
+  }
+  ASSERT_FALSE(cursor.Next());
+  auto cursor_fetches = bpm->GetStats().hits_ + bpm->GetStats().misses_;
+
+  ASSERT_EQ(visited.size(), 5000 - 100 - 1633);
+  ASSERT_EQ(visited, expected);
+  ASSERT_LT(cursor_fetches * 20, iterator_fetches);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, VacuumTest) {
+  auto schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  // Two of every three tuples are deleted, and all of [1000, 3000), which leaves whole pages without a live tuple.
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < 5000; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(0)}, schema.get());
+    rids.push_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  std::unordered_map<RID, int32_t> expected;
+  for (int32_t i = 0; i < 5000; i++) {
+    if (i % 3 != 0 || (i >= 1000 && i < 3000)) {
+      table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+    } else {
+      expected[rids[i]] = i;
+    }
+  }
+  size_t pages_before = CountPages(bpm.get(), table);
+
+  // The empty pages are unlinked, but not deleted while an iterator made before could still be on them.
+  auto iter = table.MakeIterator();
+  ASSERT_EQ(table.Vacuum(), 0);
+  size_t pages_after = CountPages(bpm.get(), table);
+  ASSERT_LT(pages_after, pages_before);
+  ASSERT_EQ(table.Vacuum(), 0);
+  ASSERT_EQ(ScanLive(std::move(iter), *schema), expected);
+  ASSERT_EQ(table.Vacuum(), pages_before - pages_after);
+
+  // The live tuples keep their RIDs.
+  ASSERT_EQ(ScanLive(table.MakeIterator(), *schema), expected);
+  for (const auto &[rid, a] : expected) {
+    auto [meta, tuple] = table.GetTuple(rid);
+    ASSERT_EQ(tuple.GetValue(schema.get(), 0).GetAs<int32_t>(), a);
+  }
+
+  // The reclaimed space takes new tuples before the heap grows. The slots of the deleted tuples are kept, so it is
+  // less than the space of the tuples.
+  for (int32_t i = 5000; i < 5400; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(0)}, schema.get());
+    expected[*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple)] = i;
+  }
+  ASSERT_EQ(CountPages(bpm.get(), table), pages_after);
+  ASSERT_EQ(ScanLive(table.MakeIterator(), *schema), expected);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BackgroundVacuumTest) {
+  auto schema = ParseCreateStatement("a integer,b integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  auto old_interval = table_heap_vacuum_interval;
+  table_heap_vacuum_interval = std::chrono::milliseconds(1);
+  table.StartBackgroundVacuum();
+
+  // Inserts and deletes race the vacuum. Every tuple but the last of each thread is deleted, so the heap shrinks back
+  // to a few pages once the vacuum catches up.
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < 4; thread_id++) {
+    threads.emplace_back([&, thread_id] {
+      for (int32_t i = 0; i < 3000; i++) {
+        Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(thread_id)}, schema.get());
+        auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+        ASSERT_TRUE(rid.has_value());
+        if (i != 2999) {
+          table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, *rid);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < 1000 && CountPages(bpm.get(), table) > 2 + TABLE_HEAP_INSERT_TARGETS; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  table.StopBackgroundVacuum();
+  table_heap_vacuum_interval = old_interval;
+
+  ASSERT_LE(CountPages(bpm.get(), table), 2 + TABLE_HEAP_INSERT_TARGETS);
+  auto tuples = ScanLive(table.MakeIterator(), *schema);
+  ASSERT_EQ(tuples.size(), 4);
+  for (const auto &[rid, a] : tuples) {
+    ASSERT_EQ(a, 2999);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  FreeSpaceMap map(bpm.get());
+
+  // Page i has i * 4 bytes free. The first 16 pages have too little room to be worth tracking.
+  for (page_id_t page_id = 0; page_id < 1000; page_id++) {
+    map.Release(page_id, page_id * 4, page_id % 7);
+  }
+  ASSERT_EQ(map.Size(), 1000 - 16);
+
+  // A tuple gets the fullest page that certainly fits it.
+  page_id_t page_id = map.Take(100);
+  ASSERT_GE(page_id * 4, 100);
+  ASSERT_LT(page_id * 4, 100 + BUSTUB_PAGE_SIZE / FreeSpaceMap::CATEGORY_COUNT);
+  ASSERT_EQ(map.Take(BUSTUB_PAGE_SIZE), INVALID_PAGE_ID);
+
+  // Loading the map back from its pages gives the same pages, tuple counts and categories.
+  for (size_t i = 0; i < 100; i++) {
+    ASSERT_NE(map.Take(i * 30), INVALID_PAGE_ID);
+  }
+  FreeSpaceMap loaded(bpm.get(), map.GetFirstPageId());
+  ASSERT_EQ(loaded.Size(), map.Size());
+  std::unordered_map<page_id_t, uint32_t> counts;
+  std::unordered_map<page_id_t, uint32_t> loaded_counts;
+  map.GetTupleCounts(&counts);
+  loaded.GetTupleCounts(&loaded_counts);
+  ASSERT_EQ(counts, loaded_counts);
+  for (const auto &[map_page_id, count] : counts) {
+    ASSERT_EQ(count, map_page_id % 7);
+  }
+  while (map.Size() > 0) {
+    ASSERT_EQ(loaded.Take(0), map.Take(0));
+  }
+}
+
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, UpdateTupleTest) {
+  auto schema = ParseCreateStatement("a integer,b varchar(1000)");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  auto make_tuple = [&](int32_t a, size_t b_length) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(b_length, 'x'))},
+                 schema.get());
+  };
+
+  std::vector<RID> rids;
+  std::unordered_map<RID, int32_t> expected;
+  for (int32_t i = 0; i < 500; i++) {
+    rids.push_back(*table.InsertTuple(meta, make_tuple(i, 10)));
+    expected[rids[i]] = i;
+  }
+  size_t pages_before = CountPages(bpm.get(), table);
+
+  // Every read finds the tuple at its RID, through the cursor too.
+  auto check = [&](const std::function<size_t(int32_t)> &b_length_of) {
+    ASSERT_EQ(ScanLive(table.MakeIterator(), *schema), expected);
+    std::unordered_map<RID, int32_t> visited;
+    TableCursor cursor(table.MakeIterator());
+    Tuple tuple;
+    while (cursor.Next()) {
+      cursor.GetTuple(&tuple);
+      ASSERT_EQ(tuple.GetRid(), cursor.GetRID());
+      ASSERT_EQ(cursor.GetTupleView().GetLength(), tuple.GetLength());
+      visited[cursor.GetRID()] = tuple.GetValue(schema.get(), 0).GetAs<int32_t>();
+    }
+    ASSERT_EQ(visited, expected);
+    for (const auto &[rid, a] : expected) {
+      auto [meta, tuple] = table.GetTuple(rid);
+      ASSERT_EQ(tuple.GetValue(schema.get(), 0).GetAs<int32_t>(), a);
+      ASSERT_EQ(tuple.GetValue(schema.get(), 1).ToString().size(), b_length_of(a));
+    }
+    std::vector<RID> live_rids;
+    for (const auto &[rid, a] : expected) {
+      live_rids.push_back(rid);
+    }
+    for (auto &[meta, tuple] : table.GetTuples(live_rids)) {
+      ASSERT_EQ(tuple.GetValue(schema.get(), 0).GetAs<int32_t>(), expected[tuple.GetRid()]);
+    }
+  };
+
+  // A tuple of the same size is updated where it is.
+  for (int32_t i = 0; i < 500; i++) {
+    ASSERT_EQ(table.UpdateTuple(meta, make_tuple(i + 1000, 10), rids[i]), rids[i]);
+    expected[rids[i]] = i + 1000;
+  }
+  check([](int32_t) { return 10; });
+  ASSERT_EQ(CountPages(bpm.get(), table), pages_before);
+
+  // Growing tuples take the free space of their page, and then move to other pages.
+  for (int32_t i = 0; i < 500; i++) {
+    ASSERT_EQ(table.UpdateTuple(meta, make_tuple(i + 2000, 200), rids[i]), rids[i]);
+    expected[rids[i]] = i + 2000;
+  }
+  check([](int32_t) { return 200; });
+  ASSERT_GT(CountPages(bpm.get(), table), pages_before);
+
+  // Moved tuples shrink where they are, or move again.
+  for (int32_t i = 0; i < 500; i++) {
+    ASSERT_EQ(table.UpdateTuple(meta, make_tuple(i + 3000, i % 2 == 0 ? 5 : 400), rids[i]), rids[i]);
+    expected[rids[i]] = i + 3000;
+  }
+  check([](int32_t a) { return a % 2 == 0 ? 5 : 400; });
+
+  // Deleting a moved tuple deletes it where it moved to, and Vacuum reclaims both.
+  for (int32_t i = 0; i < 500; i += 3) {
+    table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+    expected.erase(rids[i]);
+  }
+  check([](int32_t a) { return a % 2 == 0 ? 5 : 400; });
+  table.Vacuum();
+  table.Vacuum();
+  check([](int32_t a) { return a % 2 == 0 ? 5 : 400; });
+}
+
+TEST(TableHeapTest, UpdateSmallTupleTest) {
+  auto small_schema = ParseCreateStatement("a integer");
+  auto pair_schema = ParseCreateStatement("a integer,b integer");
+  auto schema = ParseCreateStatement("a integer,b varchar(1000)");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  auto make_tuple = [&](int32_t a, size_t b_length) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(b_length, 'x'))},
+                 schema.get());
+  };
+
+  // Fill the first page with tuples shorter than a RID.
+  std::vector<RID> rids;
+  while (true) {
+    RID rid = *table.InsertTuple(meta, Tuple({ValueFactory::GetIntegerValue(rids.size())}, small_schema.get()));
+    if (rid.GetPageId() != table.GetFirstPageId()) {
+      break;
+    }
+    rids.push_back(rid);
+  }
+  ASSERT_LT(Tuple({ValueFactory::GetIntegerValue(0)}, small_schema.get()).GetLength(), sizeof(RID));
+
+  // Other tuples grow in place into what is left of the page, until there is no room for a RID.
+  {
+    auto guard = bpm->FetchPageWrite(table.GetFirstPageId());
+    auto *page = guard.AsMut<TablePage>();
+    Tuple pair({ValueFactory::GetIntegerValue(-2), ValueFactory::GetIntegerValue(-2)}, pair_schema.get());
+    size_t grown = 1;
+    while (grown < rids.size() && page->UpdateTupleInPlace(pair, rids[grown])) {
+      grown++;
+    }
+  }
+
+  // A grown tuple has no room to leave a forward behind, so it is deleted and inserted again, once.
+  RID moved_rid = table.UpdateTuple(meta, make_tuple(-1, 100), rids[0]);
+  ASSERT_FALSE(moved_rid == rids[0]);
+  ASSERT_TRUE(table.GetTupleMeta(rids[0]).is_deleted_);
+  auto [moved_meta, moved] = table.GetTuple(moved_rid);
+  ASSERT_FALSE(moved_meta.is_deleted_);
+  ASSERT_EQ(moved.GetValue(schema.get(), 0).GetAs<int32_t>(), -1);
+  ASSERT_EQ(moved.GetValue(schema.get(), 1).ToString(), std::string(100, 'x'));
+
+  size_t live = 0;
+  size_t moved_seen = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (!meta.is_deleted_) {
+      live++;
+      moved_seen += iter.GetRID() == moved_rid ? 1 : 0;
+    }
+  }
+  ASSERT_EQ(live, rids.size() + 1);
+  ASSERT_EQ(moved_seen, 1);
+}
+
+}  // namespace bustub
@@ -17,12 +17,49 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleViewTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::INTEGER};
+  Column col3{"c", TypeId::VARCHAR, 16};
+  Schema schema{{col1, col2, col3}};
+  Tuple tuple({ValueFactory::GetVarcharValue("hello"), ValueFactory::GetIntegerValue(42),
+               ValueFactory::GetVarcharValue("")},
+              &schema);
+
+  // A view over bytes that are not a Tuple's reads the same values.
+  std::vector<char> bytes(tuple.GetData(), tuple.GetData() + tuple.GetLength());
+  TupleView view(bytes.data(), bytes.size(), RID(3, 4));
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    ASSERT_EQ(view.GetValue(&schema, i).CompareEquals(tuple.GetValue(&schema, i)), CmpBool::CmpTrue) << i;
+  }
+  ASSERT_EQ(view.GetRid(), RID(3, 4));
+
+  // Expressions evaluate on a view directly.
+  auto column = std::make_shared<ColumnValueExpression>(0, 1, TypeId::INTEGER);
+  auto constant = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(40));
+  ComparisonExpression greater(column, constant, ComparisonType::GreaterThan);
+  ASSERT_TRUE(greater.Evaluate(view, schema).GetAs<bool>());
+  ASSERT_TRUE(greater.Evaluate(&tuple, schema).GetAs<bool>());
+
+  // Materializing copies the bytes out.
+  Tuple copy = view.ToTuple();
+  bytes.assign(bytes.size(), 0);
+  ASSERT_EQ(copy.GetRid(), RID(3, 4));
+  ASSERT_EQ(copy.GetValue(&schema, 0).ToString(), "hello");
+  ASSERT_EQ(copy.GetValue(&schema, 1).GetAs<int32_t>(), 42);
+}
 // NOLINTNEXTLINE
 TEST(TupleTest, DISABLED_TableHeapTest) {
   // test1: parse create sql statement
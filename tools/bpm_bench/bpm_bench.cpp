@@ -1,4 +1,5 @@
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -18,7 +19,9 @@
 #include "common/exception.h"
 #include "common/util/string_util.h"
 #include "fmt/core.h"
+#include "fmt/format.h"
 #include "fmt/std.h"
+#include "storage/disk/disk_manager_async.h"
 #include "storage/disk/disk_manager_memory.h"
 
 #include <sys/time.h>
@@ -104,12 +107,21 @@ struct BpmMetrics {
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
+  using bustub::DiskManager;
+  using bustub::DiskManagerAsync;
   using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--shards").help("split the buffer pool into n shards");
+  program.add_argument("--numa").help("bind the shards to NUMA nodes").default_value(false).implicit_value(true);
+  program.add_argument("--stats-json").help("write the buffer pool statistics of the run to this file as JSON");
+  program.add_argument("--async-io")
+      .help("run on a database file with the asynchronous disk manager, --latency is ignored")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -129,12 +141,28 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  size_t num_shards = 1;
+  if (program.present("--shards")) {
+    num_shards = std::stoi(program.get("--shards"));
+  }
+
+  bool bind_numa_nodes = program.get<bool>("--numa");
+
+  std::unique_ptr<DiskManager> disk_manager;
+  DiskManagerUnlimitedMemory *memory_disk_manager = nullptr;
+  if (program.get<bool>("--async-io")) {
+    disk_manager = std::make_unique<DiskManagerAsync>("bpm_bench.db");
+  } else {
+    auto memory = std::make_unique<DiskManagerUnlimitedMemory>();
+    memory_disk_manager = memory.get();
+    disk_manager = std::move(memory);
+  }
+  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE, nullptr, num_shards,
+                                                 bind_numa_nodes);
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, shards={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, num_shards);
 
   for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
     page_id_t page_id;
@@ -150,7 +178,10 @@ auto main(int argc, char **argv) -> int {
   }
 
   // enable disk latency after creating all pages
-  disk_manager->SetLatency(latency_ms);
+  if (memory_disk_manager != nullptr) {
+    memory_disk_manager->SetLatency(latency_ms);
+  }
+  bpm->ResetStats();
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -228,5 +259,16 @@ auto main(int argc, char **argv) -> int {
 
   total_metrics.Report();
 
+  if (program.present("--stats-json")) {
+    std::vector<std::string> shard_stats;
+    for (size_t i = 0; i < bpm->GetNumShards(); i++) {
+      shard_stats.push_back(bpm->GetShardStats(i).ToJson());
+    }
+    std::ofstream out(program.get("--stats-json"));
+    out << fmt::format(R"({{"pool_size": {}, "total": {}, "shards": [{}]}})", bpm->GetPoolSize(),
+                       bpm->GetStats().ToJson(), fmt::join(shard_stats, ", "))
+        << std::endl;
+  }
+
   return 0;
 }
@@ -27,12 +27,13 @@ auto GetWidthOfUtf8(const void *beg, const void *end, size_t *width) -> int {
 auto main(int argc, char **argv) -> int {
   ft_set_u8strwid_func(&GetWidthOfUtf8);
 
-  auto bustub = std::make_unique<bustub::BustubInstance>("test.db");
-
   auto default_prompt = "bustub> ";
   auto emoji_prompt = "\U0001f6c1> ";  // the bathtub emoji
   bool use_emoji_prompt = false;
   bool disable_tty = false;
+  size_t bpm_size = bustub::BUSTUB_INSTANCE_BPM_SIZE;
+  int page_size = bustub::BUSTUB_PAGE_SIZE;
+  bool async_io = false;
 
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "--emoji-prompt") == 0) {
@@ -43,8 +44,19 @@ auto main(int argc, char **argv) -> int {
       disable_tty = true;
       break;
     }
+    if (strcmp(argv[i], "--bpm-size") == 0 && i + 1 < argc) {
+      bpm_size = std::stoul(argv[++i]);
+    }
+    if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) {
+      page_size = std::stoi(argv[++i]);
+    }
+    if (strcmp(argv[i], "--async-io") == 0) {
+      async_io = true;
+    }
   }
 
+  auto bustub = std::make_unique<bustub::BustubInstance>("test.db", bpm_size, page_size, async_io);
+
   bustub->GenerateMockTable();
 
   if (bustub->buffer_pool_manager_ != nullptr) {
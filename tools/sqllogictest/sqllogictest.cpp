@@ -175,6 +175,12 @@ auto main(int argc, char **argv) -> int {  // NOLINT
   program.add_argument("--verbose").help("increase output verbosity").default_value(false).implicit_value(true);
   program.add_argument("-d", "--diff").help("write diff file").default_value(false).implicit_value(true);
   program.add_argument("--in-memory").help("use in-memory backend").default_value(false).implicit_value(true);
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--page-size").help("size of a page in bytes");
+  program.add_argument("--async-io")
+      .help("use the asynchronous disk manager for the file backend")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -201,10 +207,19 @@ auto main(int argc, char **argv) -> int {  // NOLINT
 
   std::unique_ptr<bustub::BustubInstance> bustub;
 
+  size_t bpm_size = bustub::BUSTUB_INSTANCE_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoul(program.get("--bpm-size"));
+  }
+  int page_size = bustub::BUSTUB_PAGE_SIZE;
+  if (program.present("--page-size")) {
+    page_size = std::stoi(program.get("--page-size"));
+  }
+
   if (program.get<bool>("--in-memory")) {
-    bustub = std::make_unique<bustub::BustubInstance>();
+    bustub = std::make_unique<bustub::BustubInstance>(bpm_size, page_size);
   } else {
-    bustub = std::make_unique<bustub::BustubInstance>("test.db");
+    bustub = std::make_unique<bustub::BustubInstance>("test.db", bpm_size, page_size, program.get<bool>("--async-io"));
   }
 
   bustub->GenerateMockTable();
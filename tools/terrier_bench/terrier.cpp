@@ -134,6 +134,10 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
   program.add_argument("--nft").help("number of NFTs in the bench");
+  program.add_argument("--background-flush").help("write back dirty pages in a background thread");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--page-size").help("size of a page in bytes");
+  program.add_argument("--async-io").help("run on a database file with the asynchronous disk manager");
 
   size_t bustub_nft_num = 10;
 
@@ -145,9 +149,29 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  size_t bpm_size = bustub::BUSTUB_INSTANCE_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoul(program.get("--bpm-size"));
+  }
+  int page_size = bustub::BUSTUB_PAGE_SIZE;
+  if (program.present("--page-size")) {
+    page_size = std::stoi(program.get("--page-size"));
+  }
+
+  std::unique_ptr<bustub::BustubInstance> bustub;
+  if (program.present("--async-io") && ParseBool(program.get("--async-io"))) {
+    std::cerr << "x: async io enabled" << std::endl;
+    bustub = std::make_unique<bustub::BustubInstance>("terrier.db", bpm_size, page_size, true);
+  } else {
+    bustub = std::make_unique<bustub::BustubInstance>(bpm_size, page_size);
+  }
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
+  if (program.present("--background-flush") && ParseBool(program.get("--background-flush"))) {
+    std::cerr << "x: background flush enabled" << std::endl;
+    bustub->buffer_pool_manager_->StartBackgroundFlush();
+  }
+
   // create schema
   auto schema = "CREATE TABLE nft(id int, terrier int);";
   std::cerr << "x: create schema" << std::endl;